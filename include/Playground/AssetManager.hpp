@@ -0,0 +1,63 @@
+#pragma once
+
+// STD
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+#include <unordered_map>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Playground
+#include <Playground/Model.hpp>
+#include <Playground/GeometryArena.hpp>
+#include <Playground/MaterialLibrary.hpp>
+#include <Playground/ThreadPool.hpp>
+
+namespace Playground {
+	// Loads models on the workers of a shared pool and hands them to the GL thread as they finish.
+	// Models are shared between everyone that asks for the same path, scale and color.
+	class AssetManager {
+		public:
+			// The pool must outlive the asset manager
+			AssetManager(GeometryArena& arena, ThreadPool& pool);
+			AssetManager(const AssetManager&) = delete;
+			AssetManager& operator=(const AssetManager&) = delete;
+			~AssetManager();
+
+			// Returns the model, starting to load it if this is the first request for it. It can't be drawn until it is ready.
+			std::shared_ptr<Model> getModel(const std::string& path, const float scale = 1.0f, glm::vec3 color = {1.0f, 1.0f, 1.0f});
+
+			// Uploads every model and texture that finished loading. Must be called on the GL thread.
+			void update();
+
+			// Blocks until the model is loaded and uploads it. Must be called on the GL thread.
+			void wait(const std::shared_ptr<Model>& model);
+
+			// If any models or textures are still loading or waiting to be uploaded
+			bool isLoading() const;
+
+			GeometryArena& getArena();
+			MaterialLibrary& getMaterials();
+
+		private:
+			// A model that hasn't been uploaded yet
+			class PendingModel {
+				public:
+					std::shared_ptr<Model> model;
+					std::future<void> loaded;
+			};
+
+			GeometryArena& arena;
+
+			// Shared with the renderer so loading and rasterizing never run more workers than there are cores.
+			// Model loads are waited on by our destructor and texture loads by the material library's.
+			ThreadPool& pool;
+
+			MaterialLibrary materials;
+			std::unordered_map<std::string, std::shared_ptr<Model>> models;
+			std::vector<PendingModel> pending;
+	};
+}
\ No newline at end of file
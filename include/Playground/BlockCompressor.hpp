@@ -0,0 +1,28 @@
+#pragma once
+
+// STD
+#include <vector>
+#include <cstdint>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// Encodes RGBA8 images into the block compressed formats that are part of core OpenGL.
+	// Every block covers 4x4 texels, blocks that hang over the edge of the image repeat its last row and column.
+	class BlockCompressor {
+		public:
+			// Compresses an image into GL_COMPRESSED_RGBA_BPTC_UNORM, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
+			// GL_COMPRESSED_RED_RGTC1 (from the red channel) or GL_COMPRESSED_RG_RGTC2 (from the red and green channels)
+			static std::vector<uint8_t> compress(const uint8_t* rgba, int width, int height, GLenum format);
+
+			// The number of bytes one block takes in the format
+			static size_t getBlockSize(GLenum format);
+
+			// Encodes 16 RGBA8 texels into a 16 byte BC7 block using mode 6, a single subset with 4 bit indices
+			static void encodeBC7(const uint8_t* texels, uint8_t* block);
+
+			// Encodes 16 single channel values into an 8 byte BC4 block
+			static void encodeBC4(const uint8_t* values, uint8_t* block);
+	};
+}
\ No newline at end of file
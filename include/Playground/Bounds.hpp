@@ -0,0 +1,15 @@
+#pragma once
+
+// GLM
+#include <glm/glm.hpp>
+
+namespace Playground {
+	// The axis aligned bounding box and bounding sphere of a model in model space
+	class Bounds {
+		public:
+			glm::vec3 min;
+			glm::vec3 max;
+			glm::vec3 center;
+			float radius;
+	};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// STD
+#include <memory>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+// Playground
+#include <Playground/ShaderProgram.hpp>
+
+namespace Playground {
+	// A hierarchical z buffer where each texel holds the farthest depth of the area it covers.
+	// The base level is the largest power of two that fits inside of the source depth buffer.
+	class DepthPyramid {
+		public:
+			DepthPyramid(int depthWidth, int depthHeight);
+			DepthPyramid(const DepthPyramid&) = delete;
+			DepthPyramid& operator=(const DepthPyramid&) = delete;
+			~DepthPyramid();
+
+			// If the reduction program has finished compiling, see ShaderProgram::isReady
+			bool isReady();
+
+			// Rebuilds every level from depthTexture
+			void build(GLuint depthTexture);
+
+			GLuint getTexture() const;
+			int getWidth() const;
+			int getHeight() const;
+			int getLevelCount() const;
+
+		private:
+			GLuint texture;
+			std::unique_ptr<ShaderProgram> program;
+
+			int width;
+			int height;
+			int levelCount;
+	};
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// The layout glMultiDrawElementsIndirect expects for each draw in GL_DRAW_INDIRECT_BUFFER
+	class DrawCommand {
+		public:
+			GLuint count;
+			GLuint instanceCount;
+			GLuint firstIndex;
+			GLint baseVertex;
+			GLuint baseInstance;
+	};
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// STD
+#include <array>
+#include <vector>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// A persistently mapped buffer split into one region per frame in flight, each guarded by a fence.
+	// Anything that needs data on the GPU for a single frame takes an aligned allocation out of the current region and
+	// writes straight into the mapping, so the CPU fills the next frame while the GPU still reads the ones before it.
+	// A region that runs out of space moves the frame into a new buffer twice the size, the old one is deleted once the GPU is done with it.
+	class FrameRing {
+		public:
+			// The number of frames the CPU can write ahead of the GPU
+			static constexpr size_t regionCount = 3;
+
+			// Part of the current region, only valid until the end of the frame
+			class Allocation {
+				public:
+					GLuint buffer;
+					GLintptr offset; // The offset into buffer, for binding
+					GLubyte* data; // The mapping of the allocation, coherent so no flush is needed
+			};
+
+			FrameRing(GLsizeiptr regionSize);
+			FrameRing(const FrameRing&) = delete;
+			FrameRing& operator=(const FrameRing&) = delete;
+			~FrameRing();
+
+			// Moves to the next region, waiting for the GPU to finish the frame that last used it. Normally it is long done.
+			void beginFrame();
+
+			// Takes size bytes out of the current region with an offset into the buffer that is a multiple of alignment, a power of two
+			Allocation allocate(GLsizeiptr size, GLsizeiptr alignment);
+
+			// Fences the current region, call after the last command that reads from it
+			void endFrame();
+
+		private:
+			// A buffer the ring outgrew and the fence of the last frame that used it
+			class Retired {
+				public:
+					GLuint buffer;
+					GLsync fence;
+			};
+
+			GLuint buffer;
+			GLubyte* data;
+			GLsizeiptr regionSize;
+			GLsizeiptr regionAlignment;
+			size_t region;
+			GLsizeiptr head;
+			std::array<GLsync, regionCount> fences;
+			std::vector<Retired> retired;
+
+			void createBuffer(GLsizeiptr size);
+			static void deleteBuffer(GLuint name);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace Playground {
+	// Counters describing the work done by a renderer for the last frame
+	class FrameStats {
+		public:
+			unsigned int objectCount; // The number of objects in the scene
+			unsigned int submeshCount; // The number of object submeshes in the scene, the unit that gets culled and drawn
+			unsigned int culledCount; // The number of submeshes frustum culled, a frame late when culled on the GPU where meshlet culled submeshes are not counted
+			unsigned int occludedCount; // The number of submeshes occlusion culled, a frame late when culled on the GPU where meshlet culled submeshes are not counted
+			unsigned int drawCount; // The number of draw calls issued for objects
+			unsigned int stateCallCount; // The number of binds and state changes passed on to GL
+			unsigned int redundantStateCount; // The number of binds and state changes skipped because nothing would have changed
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// STD
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// GLM
+#include <glm/glm.hpp>
+
+namespace Playground {
+	class Frustum {
+		public:
+			Frustum(const glm::mat4& viewProjection);
+
+			// The normalized left, right, bottom, top, near and far planes. Points inside of the frustum have a positive distance.
+			const std::array<glm::vec4, 6>& getPlanes() const;
+
+			// Tests count world space spheres stored as a structure of arrays, four at a time.
+			// Writes 1 to visible for each sphere that intersects the frustum and 0 otherwise.
+			// Returns the number of visible spheres.
+			size_t cullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count, uint8_t* visible) const;
+
+		private:
+			std::array<glm::vec4, 6> planes;
+	};
+}
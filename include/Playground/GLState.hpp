@@ -0,0 +1,39 @@
+#pragma once
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// A cache of the context state we set that skips calls which wouldn't change anything.
+	// There is only one context so the cache is global and must only be used on the GL thread.
+	// Everything starts out unknown so the first call always goes through. Call invalidate after deleting
+	// anything that may still be bound, GL unbinds it and a new object could get the same name.
+	class GLState {
+		public:
+			// The calls made through the cache since the last resetStats
+			class Stats {
+				public:
+					unsigned int callCount; // Calls passed on to GL
+					unsigned int redundantCount; // Calls skipped because the state was already set
+			};
+
+			static void useProgram(GLuint program);
+			static void bindVertexArray(GLuint vao);
+
+			// Binds both the draw and read frame buffer
+			static void bindFramebuffer(GLuint framebuffer);
+
+			// Only for the non indexed targets
+			static void bindBuffer(GLenum target, GLuint buffer);
+			static void bindTextureUnit(GLuint unit, GLuint texture);
+			static void setEnabled(GLenum capability, bool enabled);
+			static void depthMask(GLboolean mask);
+			static void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+			// Forgets everything, the next call of each kind goes through
+			static void invalidate();
+
+			static const Stats& getStats();
+			static void resetStats();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+// STD
+#include <vector>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+// Playground
+#include <Playground/Vertex.hpp>
+#include <Playground/MeshRange.hpp>
+
+namespace Playground {
+	// Suballocates the geometry of every model out of one shared vertex and index buffer so that the
+	// vertex format only has to be bound once. Allocations live as long as the arena does.
+	// Per instance object indices are sourced from whatever buffer is given to setInstanceBuffer.
+	class GeometryArena {
+		public:
+			// The vertex format of the arena, vertex shaders declare the same locations with layout(location = N)
+			static constexpr GLuint positionLocation = 0;
+			static constexpr GLuint normalLocation = 1;
+			static constexpr GLuint colorLocation = 2;
+			static constexpr GLuint texCoordLocation = 3;
+			static constexpr GLuint instanceObjectLocation = 4;
+
+			static constexpr GLuint vertexBinding = 0;
+			static constexpr GLuint instanceBinding = 1;
+
+			GeometryArena(GLuint vertexCapacity = 1 << 16, GLuint indexCapacity = 1 << 18);
+			GeometryArena(const GeometryArena&) = delete;
+			GeometryArena& operator=(const GeometryArena&) = delete;
+			~GeometryArena();
+
+			MeshRange allocate(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices);
+
+			// Allocates indices that reference the vertices of an existing allocation
+			MeshRange allocateIndices(const MeshRange& vertexSource, const std::vector<GLuint>& indices);
+			void setInstanceBuffer(GLuint buffer, GLintptr offset = 0);
+
+			// Sources indices from another buffer, 0 restores the arena's own index buffer
+			void setElementBuffer(GLuint buffer);
+
+			GLuint getVAO() const;
+
+		private:
+			GLuint vao;
+			GLuint vbo;
+			GLuint ibo;
+
+			GLuint vertexCapacity;
+			GLuint vertexCount;
+			GLuint indexCapacity;
+			GLuint indexCount;
+
+			void grow(GLuint& buffer, GLuint& capacity, GLuint used, GLuint required, GLsizeiptr elementSize);
+	};
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// STD
+#include <string>
+
+// GLM
+#include <glm/glm.hpp>
+
+namespace Playground {
+	// A material as read from an mtl file. Texture paths are relative to the working directory, empty if unused.
+	class Material {
+		public:
+			std::string name;
+			glm::vec3 diffuse;
+			float opacity;
+			std::string diffuseTexture;
+			std::string alphaTexture;
+			std::string normalTexture;
+	};
+}
\ No newline at end of file
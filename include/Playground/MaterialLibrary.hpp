@@ -0,0 +1,138 @@
+#pragma once
+
+// STD
+#include <string>
+#include <deque>
+#include <vector>
+#include <future>
+#include <unordered_map>
+
+// GLM
+#include <glm/glm.hpp>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+// Playground
+#include <Playground/Material.hpp>
+#include <Playground/TextureData.hpp>
+#include <Playground/TextureUsage.hpp>
+#include <Playground/ThreadPool.hpp>
+
+namespace Playground {
+	// Holds the materials of every model in one shader storage buffer and their textures in texture arrays.
+	// Textures of the same size and format share an array so any material can be drawn without rebinding textures.
+	// A texture is referenced by its layer in the low 16 bits, its array in the next 8 and its most detailed uploaded level in the 4 above that.
+	// Textures are decoded and compressed on worker threads, materials draw without them until they arrive.
+	// Levels are then streamed in from the least detailed through a persistently mapped upload buffer, a few each update.
+	class MaterialLibrary {
+		public:
+			// The number of texture arrays the shaders can sample from
+			static constexpr GLuint maxTextureArrays = 8;
+
+			// The texture of materials without one
+			static constexpr GLint noTexture = -1;
+
+			// The material of faces without one, plain white
+			static constexpr GLuint defaultMaterial = 0;
+
+			// The size of the ring texture levels are staged in before being copied into their arrays
+			static constexpr GLsizeiptr uploadBufferSize = 8 * 1024 * 1024;
+
+			// How many bytes of texture levels update uploads at most, spreads large textures over several frames
+			static constexpr GLsizeiptr uploadBudget = uploadBufferSize / 4;
+
+			// The per material data shared with the shaders, matches MaterialData in the GLSL std430 layout
+			class MaterialData {
+				public:
+					glm::vec4 diffuse; // The diffuse color and opacity
+					GLint diffuseTexture;
+					GLint alphaTexture;
+					GLint normalTexture;
+					GLuint padding;
+			};
+
+			MaterialLibrary(ThreadPool& pool);
+			MaterialLibrary(const MaterialLibrary&) = delete;
+			MaterialLibrary& operator=(const MaterialLibrary&) = delete;
+			~MaterialLibrary();
+
+			// Adds a material, starting to load any textures it uses that haven't been requested yet. Must be called on the GL thread.
+			GLuint add(const Material& material);
+
+			// Uploads the next levels of the textures that finished loading and points their materials at them. Must be called on the GL thread.
+			void update();
+
+			// Binds the material buffer and the texture arrays to consecutive units starting at firstUnit
+			void bind(GLuint binding, GLuint firstUnit);
+
+			GLuint getMaterialCount() const;
+
+			// If the material lets light through and has to be drawn in the transparent pass
+			bool isTransparent(GLuint material) const;
+
+			// If the material cuts holes into its surfaces with an alpha texture
+			bool isMasked(GLuint material) const;
+
+			// If any textures are still loading or waiting to be uploaded
+			bool isLoading() const;
+
+		private:
+			// The textures of one size and format
+			class TextureArray {
+				public:
+					GLuint texture;
+					GLenum format;
+					GLsizei width;
+					GLsizei height;
+					GLsizei levelCount;
+					GLsizei layerCount;
+					GLsizei layerCapacity;
+			};
+
+			// A material waiting for a texture to be uploaded and which of its textures it is
+			class TextureWaiter {
+				public:
+					GLuint material;
+					GLint MaterialData::* texture;
+			};
+
+			// A texture that hasn't been fully uploaded yet, once loaded is taken its levels are streamed from the end
+			class PendingTexture {
+				public:
+					std::future<TextureData> loaded;
+					std::vector<TextureWaiter> waiters;
+					TextureData data;
+					GLint texture; // The array and layer, without a level
+					GLint nextLevel; // The next level to upload
+					GLint resident; // The handle materials currently use
+			};
+
+			// A level copied out of the upload buffer, the range can be reused once the fence signals
+			class Upload {
+				public:
+					GLsync fence;
+					GLintptr offset;
+			};
+
+			ThreadPool& pool;
+			GLuint materialBuffer;
+			bool materialsDirty;
+			std::vector<MaterialData> materials;
+			std::vector<bool> masked; // If each material has an alpha texture, even while it is still loading
+			std::vector<TextureArray> textureArrays;
+			std::unordered_map<std::string, GLint> textureLookup;
+			std::unordered_map<std::string, PendingTexture> pending;
+			GLuint uploadBuffer;
+			GLubyte* uploadData;
+			GLintptr uploadHead;
+			std::deque<Upload> uploads;
+
+			void requestTexture(const std::string& path, TextureUsage usage, GLuint material, GLint MaterialData::* texture);
+			void setResident(PendingTexture& entry, GLint resident);
+			bool uploadLevel(PendingTexture& entry);
+			GLintptr allocateUpload(GLsizeiptr size);
+			GLint addLayer(const TextureData& data);
+			void growArray(TextureArray& array, GLsizei layerCapacity);
+	};
+}
\ No newline at end of file
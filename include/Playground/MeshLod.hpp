@@ -0,0 +1,13 @@
+#pragma once
+
+// Playground
+#include <Playground/MeshRange.hpp>
+
+namespace Playground {
+	// One level of detail of a model. All levels share the vertices of the most detailed one.
+	class MeshLod {
+		public:
+			MeshRange mesh; // The indices of this level
+			float error; // The largest distance from the most detailed level in model space units
+	};
+}
\ No newline at end of file
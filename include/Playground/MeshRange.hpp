@@ -0,0 +1,14 @@
+#pragma once
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// A range of indexed geometry inside of a GeometryArena
+	class MeshRange {
+		public:
+			GLuint firstIndex; // The offset of the first index in the arena's index buffer
+			GLuint count; // The number of indices
+			GLint baseVertex; // The offset added to each index to get the arena vertex
+	};
+}
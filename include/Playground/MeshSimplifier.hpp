@@ -0,0 +1,69 @@
+#pragma once
+
+// STD
+#include <vector>
+#include <cstddef>
+
+// GLM
+#include <glm/glm.hpp>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// Progressively simplifies an indexed triangle mesh with quadric error metrics.
+	// Only the vertices referenced by the indices are considered so a mesh can be simplified in parts.
+	// Edges are collapsed onto one of their existing vertices so every level of detail can share the original vertex data.
+	// Vertices on open borders and on attribute seams (positions shared by multiple vertices) are never moved.
+	class MeshSimplifier {
+		public:
+			MeshSimplifier(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& indices);
+
+			// Collapses edges until there are at most targetIndexCount indices left or nothing more can be collapsed.
+			// Successive calls continue from the previous result. Returns false if no edges could be collapsed.
+			bool simplify(size_t targetIndexCount);
+
+			// The current simplified indices
+			const std::vector<GLuint>& getIndices() const;
+
+			// The largest distance from the original surface introduced so far, in model space units
+			float getError() const;
+
+		private:
+			// A symmetric 4x4 plane quadric along with the area it was accumulated from
+			class Quadric {
+				public:
+					double a00, a01, a02, a03;
+					double a11, a12, a13;
+					double a22, a23;
+					double a33;
+					double weight;
+
+					void add(const Quadric& other);
+					void addPlane(const glm::vec3& normal, double distance, double weight);
+					double evaluate(const glm::vec3& point) const;
+			};
+
+			// A potential collapse of the vertex from onto the vertex to
+			class Collapse {
+				public:
+					GLuint from;
+					GLuint to;
+					double cost;
+			};
+
+			std::vector<GLuint> vertices; // The original index of each vertex used by the mesh
+			std::vector<glm::vec3> positions; // Indexed by vertex
+			std::vector<GLuint> indices; // Indices into vertices
+			std::vector<GLuint> result; // The current indices in terms of the original vertices
+			std::vector<GLuint> wedges; // The first vertex with the same position as each vertex
+			std::vector<GLuint> remap; // The vertex each vertex has been collapsed onto
+			std::vector<Quadric> quadrics; // Indexed by wedge
+			std::vector<bool> locked; // Indexed by wedge
+			std::vector<bool> seams; // Indexed by wedge
+			double maxCost;
+
+			GLuint resolve(GLuint vertex) const;
+			bool flipsTriangle(GLuint from, GLuint to, const std::vector<GLuint>& adjacency, const std::vector<GLuint>& adjacencyOffsets) const;
+	};
+}
\ No newline at end of file
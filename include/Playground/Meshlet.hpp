@@ -0,0 +1,26 @@
+#pragma once
+
+// GLM
+#include <glm/glm.hpp>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// A small cluster of triangles of a model that can be culled on its own. Matches Meshlet in the GLSL std430 layout.
+	class Meshlet {
+		public:
+			// The maximum size of a meshlet
+			static constexpr GLuint maxVertices = 64;
+			static constexpr GLuint maxTriangles = 124;
+
+			glm::vec3 center; // The model space center of the bounding sphere
+			float radius; // The radius of the bounding sphere
+			glm::vec3 coneAxis; // The average direction of the triangle normals
+			float coneCutoff; // The sine of the angle between the cone axis and the furthest normal, 1 if the cone can't be used for culling
+			GLuint vertexOffset; // The offset of the first vertex in Model::getMeshletVertices
+			GLuint triangleOffset; // The offset of the first triangle in Model::getMeshletTriangles
+			GLuint vertexCount;
+			GLuint triangleCount;
+	};
+}
\ No newline at end of file
@@ -9,23 +9,71 @@
 
 // Playground
 #include <Playground/Vertex.hpp>
+#include <Playground/MeshRange.hpp>
+#include <Playground/Submesh.hpp>
+#include <Playground/Bounds.hpp>
+#include <Playground/GeometryArena.hpp>
+#include <Playground/Material.hpp>
+#include <Playground/MaterialLibrary.hpp>
 
 namespace Playground {
+	// Models are loaded in two steps so the expensive part can happen on a worker thread.
+	// The constructor only records what to load, load does the CPU side work and upload hands the geometry to the GPU.
 	class Model {
 		public:
 			Model(const std::string& path, const float scale = 1.0f, glm::vec3 color = {1.0f, 1.0f, 1.0f});
 			virtual ~Model();
 
-			void setupForUseWith(GLuint program);
+			// Loads the obj and builds the submeshes, levels of detail and meshlets. Safe to call from any thread.
+			void load();
 
-			GLuint getVAO();
-			GLuint getCount();
+			// Uploads the loaded geometry to the arena and the materials to the library. Must be called on the GL thread after load.
+			void upload(GeometryArena& arena, MaterialLibrary& library);
+
+			// If the model has been uploaded and can be drawn
+			bool isReady() const;
+
+			const std::string& getPath() const;
+
+			// The maximum number of levels of detail generated for a model
+			static constexpr size_t maxLodCount = 4;
+
+			// The most detailed level of every submesh, which are stored back to back
+			const MeshRange& getMesh() const;
+			const Bounds& getBounds() const;
+			GLuint getCount() const;
+
+			const std::vector<Submesh>& getSubmeshes() const;
+
+			// The materials of the obj, indexed by Submesh::material
+			const std::vector<Material>& getMaterials() const;
+
+			// A CPU side copy of the geometry for software rasterization
+			const std::vector<glm::vec3>& getPositions() const;
+			const std::vector<GLuint>& getIndices() const;
 
 		private:
-			GLuint vao;
-			GLuint vbo;
-			GLuint count;
+			std::string path;
+			float scale;
+			glm::vec3 color;
+			bool ready;
+
+			// The data only needed until upload
+			std::vector<Vertex> vertices;
+			std::vector<GLuint> lodIndices; // The indices of every level after the first, of every submesh
+
+			MeshRange mesh;
+			Bounds bounds;
+			std::vector<Submesh> submeshes;
+			std::vector<Material> materials;
+			std::vector<glm::vec3> positions;
+			std::vector<GLuint> indices;
+
+			Bounds calculateBounds(const std::vector<GLuint>& indices) const;
+			void generateLods(Submesh& submesh, const std::vector<GLuint>& indices);
+			void buildMeshlets(Submesh& submesh, const std::vector<GLuint>& indices, std::vector<GLuint>& localIndices);
+			void finishMeshlet(Submesh& submesh, Meshlet& meshlet);
 
-			void load(const std::string& path, const float scale, glm::vec3 color, std::vector<Vertex>& data);
+			void loadObj(std::vector<std::vector<GLuint>>& submeshIndices, std::vector<int>& submeshMaterials);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// STD
+#include <vector>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Playground
+#include <Playground/Bounds.hpp>
+#include <Playground/ThreadPool.hpp>
+
+namespace Playground {
+	// A low resolution depth buffer that large occluders are rasterized into on the CPU.
+	// Object bounds can then be tested against it before any draw calls are issued.
+	// Vertices are transformed and triangles are setup in chunks on the pool, each chunk binning its triangles to the bands they touch.
+	// Rows are split into bands that are rasterized in parallel, four pixels at a time.
+	class OcclusionBuffer {
+		public:
+			static constexpr int tileSize = 8;
+			static constexpr size_t vertexChunkSize = 4096; // The number of vertices transformed by each task
+			static constexpr size_t triangleChunkSize = 1024; // The number of triangles setup by each task
+
+			OcclusionBuffer(int width, int height, ThreadPool& pool);
+
+			// Clears the buffer and sets the view projection used by the following calls
+			void begin(const glm::mat4& viewProjection);
+
+			// Queues an occluder to be rasterized, the positions and indices must stay valid until rasterize returns
+			void addOccluder(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& indices, const glm::mat4& modelMatrix);
+
+			// Queues a range of an occluder's indices, consecutive ranges of the same occluder share its transformed vertices
+			void addOccluder(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& indices, const glm::mat4& modelMatrix, size_t firstIndex, size_t indexCount);
+
+			// Transforms, sets up and rasterizes the front facing triangles of every occluder added since begin
+			void rasterize();
+
+			// Returns false if the bounds are entirely hidden behind the rasterized occluders
+			bool isVisible(const Bounds& bounds, const glm::mat4& modelMatrix) const;
+
+			int getWidth() const;
+			int getHeight() const;
+			const std::vector<float>& getDepth() const;
+
+		private:
+			// A screen space triangle setup for rasterization with edge functions
+			class Triangle {
+				public:
+					glm::vec3 edgeX; // The x coefficient of each edge function
+					glm::vec3 edgeY; // The y coefficient of each edge function
+					glm::vec3 edgeC; // The constant of each edge function
+					glm::vec3 depth; // The x, y and constant coefficients of the depth plane
+					int minX;
+					int minY;
+					int maxX;
+					int maxY;
+			};
+
+			class Occluder {
+				public:
+					const std::vector<glm::vec3>* positions;
+					const std::vector<GLuint>* indices;
+					glm::mat4 modelViewProjection;
+					size_t firstClipPosition; // The offset of this occluder's vertices in clipPositions
+					size_t firstRange; // The first of this occluder's index ranges in ranges
+					size_t rangeCount;
+			};
+
+			// The indices of an occluder that are rasterized
+			class IndexRange {
+				public:
+					size_t firstIndex;
+					size_t indexCount;
+			};
+
+			// A range of an occluder's triangles along with the triangles that survived setup, binned by band
+			class SetupChunk {
+				public:
+					const Occluder* occluder;
+					size_t firstIndex;
+					size_t lastIndex;
+					std::vector<Triangle> triangles;
+					std::vector<std::vector<GLuint>> bins; // The triangles touching each band
+			};
+
+			int width;
+			int height;
+			int pitch; // The width rounded up to a multiple of four
+			int tilesX;
+			int tilesY;
+
+			ThreadPool& pool;
+			glm::mat4 viewProjection;
+
+			std::vector<float> depth; // The nearest occluder depth of each pixel
+			std::vector<float> tileDepth; // The farthest depth in each tile
+			std::vector<Occluder> occluders;
+			std::vector<IndexRange> ranges;
+			std::vector<glm::vec4> clipPositions;
+			std::vector<SetupChunk> chunks; // Kept between frames so their storage is reused
+			size_t chunkCount;
+
+			void transformVertices(const Occluder& occluder, size_t first, size_t last);
+			void setupTriangles(SetupChunk& chunk);
+			void rasterizeBand(int tileY);
+	};
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// STD
+#include <cstdint>
+#include <ostream>
+
+namespace Playground {
+	enum class Placement : uint8_t {
+		GRID, // Evenly spaced on a square grid
+		RANDOM, // Uniformly scattered over the whole area
+		CLUSTERED, // Scattered around a few random cluster centers
+	};
+}
+
+std::ostream& operator<<(std::ostream& os, const Playground::Placement placement);
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+// STD
+#include <cstdint>
+#include <vector>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// Orders draws by a packed 64 bit key so that draws sharing state end up next to each other.
+	// From most to least significant the key holds the pass, program, material, vertex array and depth,
+	// so state changes are grouped first and draws within a group go front to back for early depth rejection.
+	// The program and vertex array are dense indices assigned by the owner of the queue rather than GL names, which may not fit their bits.
+	class RenderQueue {
+		public:
+			static constexpr unsigned int passBits = 4;
+			static constexpr unsigned int programBits = 8;
+			static constexpr unsigned int materialBits = 16;
+			static constexpr unsigned int vertexArrayBits = 8;
+			static constexpr unsigned int depthBits = 28;
+
+			// Passes drawn in order
+			static constexpr GLuint opaquePass = 0;
+			static constexpr GLuint transparentPass = 1;
+
+			// A queued draw, item is whatever the owner of the queue wants to draw
+			class Entry {
+				public:
+					uint64_t key;
+					GLuint item;
+			};
+
+			// Packs a key. Fields must fit their bits, depth must not be negative.
+			static uint64_t makeKey(GLuint pass, GLuint program, GLuint material, GLuint vertexArray, float depth);
+
+			// Unpacks the pass of a key
+			static GLuint getPass(uint64_t key);
+
+			void clear();
+			void push(uint64_t key, GLuint item);
+
+			// Sorts the entries by key with a least significant digit radix sort
+			void sort();
+
+			const std::vector<Entry>& getEntries() const;
+
+		private:
+			std::vector<Entry> entries;
+			std::vector<Entry> scratch;
+	};
+}
\ No newline at end of file
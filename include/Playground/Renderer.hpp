@@ -2,6 +2,7 @@
 
 // Playground
 #include <Playground/Camera.hpp>
+#include <Playground/FrameStats.hpp>
 
 namespace Playground {
 	class Renderer {
@@ -11,5 +12,6 @@ namespace Playground {
 
 			virtual void draw(const Camera& camera) = 0;
 			virtual int getFrameBuffer() const = 0;
+			virtual const FrameStats& getFrameStats() const = 0;
 	};
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
 // STD
+#include <cstdint>
 #include <memory>
+#include <vector>
+#include <unordered_map>
 
 // glLoadGen
 #include <glloadgen/gl_core_4_5.h>
@@ -9,37 +12,137 @@
 // Playground
 #include <Playground/Renderer.hpp>
 #include <Playground/Model.hpp>
+#include <Playground/GeometryArena.hpp>
+#include <Playground/AssetManager.hpp>
 #include <Playground/PointLight.hpp>
-#include <Playground/Renderable.hpp>
+#include <Playground/Scene.hpp>
 #include <Playground/AntiAliasingMode.hpp>
+#include <Playground/SubmissionMode.hpp>
+#include <Playground/DrawCommand.hpp>
+#include <Playground/Meshlet.hpp>
+#include <Playground/DepthPyramid.hpp>
+#include <Playground/FrameRing.hpp>
+#include <Playground/OcclusionBuffer.hpp>
+#include <Playground/RenderQueue.hpp>
+#include <Playground/ShaderProgram.hpp>
+#include <Playground/ShaderVariants.hpp>
+#include <Playground/ThreadPool.hpp>
 
 namespace Playground {
 	class RendererForward : public Renderer {
 		public:
-			RendererForward(const int width, const int height, const AntiAliasingMode mode, const int power, int screenScale, const std::vector<Renderable>& objects, const std::vector<PointLight>& lights);
+			RendererForward(const int width, const int height, const AntiAliasingMode mode, const int power, int screenScale, const SubmissionMode submission, AssetManager& assets, ThreadPool& pool, const Scene& scene, const std::vector<PointLight>& lights);
 			virtual ~RendererForward();
 
 			virtual void draw(const Camera& camera) override;
 			virtual int getFrameBuffer() const override;
+			virtual const FrameStats& getFrameStats() const override;
 
 		private:
+			// The screen space error in pixels we allow a level of detail to introduce
+			static constexpr float lodErrorThreshold = 1.0f;
+
+			// Submeshes with at least this many meshlets are culled per meshlet when submitting on the GPU instead of being batched
+			static constexpr size_t minMeshletCount = 16;
+
+			// The batch of draw items that are not drawn by a batch
+			static constexpr GLuint noBatch = 0xFFFFFFFF;
+
+			// One submesh of one object, the unit we cull and draw
+			class DrawItem {
+				public:
+					GLuint object;
+					const Submesh* submesh;
+			};
+
+			// A group of draw items that share a submesh and level of detail and are drawn with a single instanced draw call
+			class Batch {
+				public:
+					const Submesh* submesh;
+					GLuint lod;
+					GLuint firstInstance;
+					GLuint instanceCount;
+			};
+
+			// The model program variant a pass draws with and its uniform locations, looked up once when the variant is ready
+			class ModelProgram {
+				public:
+					ShaderProgram* program;
+					GLint viewProjectionLocation;
+					GLint viewPositionLocation;
+					GLint lightCountLocation;
+					GLint alphaToCoverageLocation;
+					GLint transparentPassLocation;
+			};
+
+			// The per draw item data shared with the shaders, matches ObjectData in the GLSL std430 layout
+			class ObjectData {
+				public:
+					glm::mat4 modelMatrix;
+					glm::vec4 boundingSphere; // The model space center and radius
+					GLuint batch; // The batch of the most detailed level, less detailed levels follow it
+					GLuint lodCount;
+					GLuint material; // The index into the material library
+					GLuint padding;
+			};
+
+			// One meshlet of one draw item for the meshlet cull shader, matches MeshletWork in the GLSL std430 layout
+			class MeshletWork {
+				public:
+					GLuint object; // The draw item
+					GLuint meshlet; // The index into the meshlet buffer
+					GLuint command; // The draw command of the object
+					GLuint padding;
+			};
+
 			GLuint fbo;
 			GLuint fboColorTexture;
 			GLuint fboDepthTexture;
 
+			// The multisampled targets we draw into when using MSAA, resolved into fbo before anything reads them
+			GLuint fboMultisample;
+			GLuint fboMultisampleColor;
+			GLuint fboMultisampleDepth; // A texture so the depth can be resolved by a shader
+
+			// The weighted blended order independent transparency targets, composited over fbo. The depth is shared with fbo.
+			GLuint fboTransparent;
+			GLuint fboAccumulationTexture;
+			GLuint fboRevealageTexture;
+
 			GLuint fboScreen;
 			GLuint fboScreenColorTexture;
 
-			GLuint modelProgram;
-			GLuint screenProgram;
+			std::unique_ptr<ShaderVariants> modelPrograms;
+			ModelProgram passPrograms[2]; // Indexed by the RenderQueue pass, empty until the pass's variant is ready
+			std::unique_ptr<ShaderProgram> screenProgram;
+			std::unique_ptr<ShaderProgram> compositeProgram;
+			std::unique_ptr<ShaderProgram> depthResolveProgram; // Only created when using MSAA
+			std::unique_ptr<ShaderProgram> cullProgram;
+			std::unique_ptr<ShaderProgram> meshletProgram;
 			GLuint ubo;
+			GLuint objectBuffer;
+			GLuint instanceBuffer;
+			GLuint commandBuffer;
+			GLuint commandTemplateBuffer;
+			GLuint lodErrorBuffer;
+			GLuint meshletBuffer;
+			GLuint meshletVertexBuffer;
+			GLuint meshletTriangleBuffer;
+			GLuint meshletWorkBuffer;
+			GLuint meshletIndexBuffer;
 
-			GLint mvpLocation;
-			GLint modelMatrixLocation;
-			GLint viewPositionLocation;
-			GLint lightCountLocation;
 			GLint colorAttachmentLocation;
-			GLint scaleLocation;
+			GLint frustumPlanesLocation;
+			GLint objectCountLocation;
+			GLint occlusionCullingLocation;
+			GLint previousViewProjectionLocation;
+			GLint cullViewPositionLocation;
+			GLint lodScaleLocation;
+			GLint meshletFrustumPlanesLocation;
+			GLint meshletWorkCountLocation;
+			GLint meshletOcclusionCullingLocation;
+			GLint meshletPreviousViewProjectionLocation;
+			GLint meshletViewPositionLocation;
 
 			GLuint lightCount;
 
@@ -48,9 +151,91 @@ namespace Playground {
 			int screenWidth;
 			int screenHeight;
 			int scale;
+			int sampleCount;
 
-			const std::vector<Renderable>& objects;
+			SubmissionMode submission;
+			FrameStats stats;
+			GeometryArena& arena;
+			MaterialLibrary& materials;
+			const Scene& scene;
 			const std::vector<PointLight>& lights;
 			std::shared_ptr<Model> unitPlane;
+
+			// The scene as of the last buildObjects, items and batches are only rebuilt when nodes are added or finish loading
+			size_t builtNodeCount;
+			size_t builtReadyCount;
+
+			std::vector<DrawItem> items;
+			std::vector<GLuint> nodeItems; // The first draw item of each scene node, followed by the total item count
+			std::vector<Batch> batches;
+			std::unordered_map<const Submesh*, size_t> batchLookup;
+			std::vector<GLuint> batchCursors;
+			std::vector<GLuint> instanceData;
+			std::vector<ObjectData> objectData;
+			std::vector<DrawCommand> commands;
+			std::vector<GLfloat> lodErrors;
+			size_t batchCommandCount;
+			size_t opaqueBatchCount; // The opaque batches come first followed by the transparent ones
+
+			// The meshlets of every submesh that is culled per meshlet, concatenated
+			std::unordered_map<const Submesh*, GLuint> meshletLookup;
+			std::vector<Meshlet> meshletData;
+			std::vector<GLuint> meshletVertexData;
+			std::vector<GLuint> meshletTriangleData;
+			std::vector<MeshletWork> meshletWork;
+			std::vector<GLuint> meshletInstances;
+
+			// The per frame object and instance data of CPU submission
+			std::unique_ptr<FrameRing> frameRing;
+			GLint storageAlignment;
+
+			// The depth of the previous frame used for occlusion culling on the GPU
+			std::unique_ptr<DepthPyramid> depthPyramid;
+			glm::mat4 previousViewProjection;
+			bool depthPyramidValid;
+
+			// The frustum culled and occluded counts written by the cull shader.
+			// They are double buffered and read back a frame late once their fence has signaled so we never wait on them.
+			GLuint cullCountBuffers[2];
+			GLsync cullCountFences[2];
+			GLuint cullCounts[2]; // The latest counts read back
+			int cullCountIndex; // The buffer written this frame
+
+			// If the programs every frame needs have finished compiling and their uniforms have been looked up
+			bool programsReady;
+
+			// The world space bounding spheres of our draw items as a structure of arrays for SIMD culling
+			std::vector<float> sphereX;
+			std::vector<float> sphereY;
+			std::vector<float> sphereZ;
+			std::vector<float> sphereRadius;
+			std::vector<uint8_t> objectVisible;
+			std::vector<uint8_t> objectLod;
+			std::vector<float> objectDistance; // The distance from the camera to the closest point of the bounding sphere
+
+			// The batches with visible instances in the order we draw them
+			RenderQueue renderQueue;
+			std::vector<float> batchDistances;
+
+			// Large occluders are rasterized on the CPU to hide the objects behind them
+			OcclusionBuffer occlusionBuffer;
+
+			bool pollPrograms();
+			size_t countReadyObjects() const;
+			bool usesMeshlets(const Submesh& submesh) const;
+			void buildObjects();
+			void buildInstances();
+			void buildQueue();
+			void buildCommands();
+			ShaderProgram& getModelProgram(GLuint pass);
+			void useModelProgram(GLuint pass, const glm::mat4& viewProjection, const glm::vec3& viewPosition);
+			void drawQueue(GLuint pass);
+			void drawTransparent(const glm::mat4& viewProjection, const glm::vec3& viewPosition);
+			void updateTransforms();
+			void uploadFrameData();
+			void cullObjectsCPU(const glm::mat4& viewProjection);
+			void occlusionCullObjectsCPU(const glm::mat4& viewProjection);
+			void selectLodsCPU(const glm::vec3& viewPosition, float lodScale);
+			void cullObjectsGPU(const glm::mat4& viewProjection, const glm::vec3& viewPosition, float lodScale);
 	};
 }
\ No newline at end of file
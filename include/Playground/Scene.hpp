@@ -0,0 +1,70 @@
+#pragma once
+
+// STD
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+// Playground
+#include <Playground/Model.hpp>
+
+namespace Playground {
+	// The objects of a scene stored as a structure of arrays and indexed by node.
+	// Nodes are only added after their parent so a single pass in order visits every parent before its children.
+	// World matrices are only recomputed for nodes that changed and their descendants, a scene that doesn't move costs nothing to update.
+	class Scene {
+		public:
+			// The parent of root nodes
+			static constexpr GLuint noParent = 0xFFFFFFFF;
+
+			Scene();
+
+			// Adds a node and returns its index. The model may be null for nodes that only group their children.
+			GLuint addNode(std::shared_ptr<Model> model, const glm::vec3& translation, bool occluder = false, GLuint parent = noParent);
+
+			void setTranslation(GLuint node, const glm::vec3& translation);
+			void setRotation(GLuint node, const glm::quat& rotation);
+			void setScale(GLuint node, const glm::vec3& scale);
+
+			// Recomputes the world matrices of the changed nodes. Call once per frame before drawing.
+			void update();
+
+			// The nodes whose world matrix changed in the last update
+			const std::vector<GLuint>& getChangedNodes() const;
+
+			GLuint getNodeCount() const;
+			GLuint getParent(GLuint node) const;
+			const std::shared_ptr<Model>& getModel(GLuint node) const;
+			bool isOccluder(GLuint node) const;
+			const glm::vec3& getTranslation(GLuint node) const;
+			const glm::quat& getRotation(GLuint node) const;
+			const glm::vec3& getScale(GLuint node) const;
+			const glm::mat4& getWorldMatrix(GLuint node) const;
+
+		private:
+			// Local transforms
+			std::vector<glm::vec3> translations;
+			std::vector<glm::quat> rotations;
+			std::vector<glm::vec3> scales;
+			std::vector<GLuint> parents;
+
+			// Derived data
+			std::vector<glm::mat4> worldMatrices;
+			std::vector<uint8_t> dirty; // If the local transform changed since the last update
+			std::vector<GLuint> changedNodes;
+			GLuint firstDirty; // No node before this one is dirty
+
+			// What to draw
+			std::vector<std::shared_ptr<Model>> models;
+			std::vector<uint8_t> occluders; // If the node should be rasterized into the CPU occlusion buffer
+
+			void markDirty(GLuint node);
+	};
+}
\ No newline at end of file
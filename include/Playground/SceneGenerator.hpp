@@ -0,0 +1,65 @@
+#pragma once
+
+// STD
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Playground
+#include <Playground/AssetManager.hpp>
+#include <Playground/Scene.hpp>
+#include <Playground/PointLight.hpp>
+#include <Playground/Placement.hpp>
+#include <Playground/SubmissionMode.hpp>
+#include <Playground/AntiAliasingMode.hpp>
+
+namespace Playground {
+	// Builds deterministic benchmark scenes so renderers can be compared as object and light counts grow.
+	// The same settings always produce the same scene.
+	class SceneGenerator {
+		public:
+			class Settings {
+				public:
+					uint32_t seed = 256; // The seed for every random choice
+					std::string model; // A model name (cube, teapot, sponza, ball) or obj path to instance, empty for the default scene
+					float modelScale = 1.0f; // The scale used when model is a path
+					unsigned int objectCount = 100; // The number of instances of model
+					Placement objectPlacement = Placement::GRID;
+					float objectHeight = 0.0f; // Instances are placed between zero and this height
+					unsigned int lightCount = 256;
+					Placement lightPlacement = Placement::GRID;
+					float lightHeight = 20.0f; // Lights are placed between zero and this height
+					float extent = 80.0f; // Everything is placed within [-extent, extent] on the x and z axes
+					unsigned int clusterCount = 8; // The number of clusters for clustered placement
+
+					// How the renderer draws the scene, not used by generate
+					SubmissionMode submission = SubmissionMode::CPU;
+					AntiAliasingMode antiAliasing = AntiAliasingMode::NONE;
+					int sampleCount = 4; // The anti-aliasing power, samples per pixel for MSAA
+			};
+
+			SceneGenerator(const Settings& settings);
+
+			// Reads settings from arguments of the form --name value. Throws std::runtime_error on anything it doesn't understand.
+			static Settings parseArguments(int argc, char* argv[]);
+
+			// The command line options accepted by parseArguments
+			static std::string getUsage();
+
+			// Requests the models from assets and adds the objects and lights of the scene
+			void generate(AssetManager& assets, Scene& scene, std::vector<PointLight>& lights);
+
+			const Settings& getSettings() const;
+
+		private:
+			Settings settings;
+			std::mt19937 random;
+
+			// Picks count positions in the settings' extent with heights between zero and height
+			std::vector<glm::vec3> place(Placement placement, unsigned int count, float height);
+	};
+}
\ No newline at end of file
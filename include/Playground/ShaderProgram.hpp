@@ -0,0 +1,72 @@
+#pragma once
+
+// STD
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// A program linked from shader files, optionally specialized with preprocessor defines inserted after the #version line.
+	// Lines of the form #include "file" are replaced with the contents of the file, relative to the including file.
+	// The linked binary is cached next to the first stage in a file named after the hash of the sources and the driver,
+	// later runs load it instead of compiling and fall back to the sources if the driver rejects it.
+	// Compiling only starts in the constructor, nothing waits on the driver until the program is polled as ready or first used.
+	class ShaderProgram {
+		public:
+			// Bump whenever the cache file layout changes
+			static constexpr uint32_t cacheVersion = 1;
+
+			// One stage of the program and the file its source is read from
+			class Stage {
+				public:
+					GLenum type;
+					std::string path;
+			};
+
+			// A preprocessor define added to every stage, the value may be empty
+			class Define {
+				public:
+					std::string name;
+					std::string value;
+			};
+
+			ShaderProgram(const std::vector<Stage>& stages, const std::vector<Define>& defines = {});
+			ShaderProgram(const ShaderProgram&) = delete;
+			ShaderProgram& operator=(const ShaderProgram&) = delete;
+			~ShaderProgram();
+
+			// The name of the program, using it before it is ready waits for the driver to finish linking
+			GLuint getProgram() const;
+
+			// If the driver is done linking, never waits when GL_KHR_parallel_shader_compile is supported and always waits otherwise
+			bool isReady();
+
+			// If the program linked, from source or from the cache. Waits for the driver to finish linking.
+			bool isLinked();
+
+			// Looked up once per name and remembered, -1 for uniforms the program doesn't use. Waits for the driver to finish linking.
+			GLint getUniformLocation(const std::string& name);
+
+		private:
+			GLuint program;
+			bool linked;
+			bool finished;
+			std::string cachePath;
+			std::vector<GLuint> shaders;
+			std::unordered_map<std::string, GLint> uniformLocations;
+
+			static std::string addIncludes(const std::string& source, const std::string& path, int depth = 0);
+			static std::string addDefines(const std::string& source, const std::vector<Define>& defines);
+			static std::string getCachePath(const std::vector<Stage>& stages, const std::vector<std::string>& sources);
+			bool loadBinary(const std::string& cachePath);
+			void saveBinary(const std::string& cachePath) const;
+			void link(const std::vector<Stage>& stages, const std::vector<std::string>& sources);
+
+			// Reports any errors, releases the shaders and caches the binary once linking is done
+			void finish();
+	};
+}
\ No newline at end of file
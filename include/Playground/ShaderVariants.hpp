@@ -0,0 +1,32 @@
+#pragma once
+
+// STD
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+// Playground
+#include <Playground/ShaderProgram.hpp>
+
+namespace Playground {
+	// The programs built from the same stages with different defines, each one is built the first time it is asked for.
+	// Shaders keep a uniform for everything they can be specialized on, a variant that fails to build falls back to the program without defines.
+	// Variants are returned while they are still compiling, check ShaderProgram::isReady before drawing with one to avoid waiting on it.
+	class ShaderVariants {
+		public:
+			ShaderVariants(const std::vector<ShaderProgram::Stage>& stages);
+			ShaderVariants(const ShaderVariants&) = delete;
+			ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+			// Gets the variant with the defines, the order of the defines matters
+			ShaderProgram& get(const std::vector<ShaderProgram::Define>& defines);
+
+			// Gets the program without defines that reads everything from uniforms
+			ShaderProgram& getFallback();
+
+		private:
+			std::vector<ShaderProgram::Stage> stages;
+			std::unordered_map<std::string, std::unique_ptr<ShaderProgram>> variants;
+	};
+}
\ No newline at end of file
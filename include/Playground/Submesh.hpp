@@ -0,0 +1,38 @@
+#pragma once
+
+// STD
+#include <vector>
+#include <cstddef>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+// Playground
+#include <Playground/Bounds.hpp>
+#include <Playground/MeshLod.hpp>
+#include <Playground/Meshlet.hpp>
+
+namespace Playground {
+	// The faces of one obj shape that share a material. Submeshes are culled and drawn on their own.
+	class Submesh {
+		public:
+			int material; // The index of the obj material, -1 if the faces have none
+			GLuint materialId; // The material in the MaterialLibrary, set on upload
+			Bounds bounds; // The model space bounds of only this submesh
+
+			// The levels of detail of this submesh, from most to least detailed
+			std::vector<MeshLod> lods;
+
+			// The meshlets of the most detailed level of detail
+			std::vector<Meshlet> meshlets;
+
+			// The vertices used by each meshlet, relative to the base vertex of the model
+			std::vector<GLuint> meshletVertices;
+
+			// The triangles of each meshlet as three 8 bit indices into the meshlet's vertices
+			std::vector<GLuint> meshletTriangles;
+
+			// Selects the least detailed level whose error is at most one unit after being multiplied by errorScale
+			size_t selectLod(float errorScale) const;
+	};
+}
\ No newline at end of file
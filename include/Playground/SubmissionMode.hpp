@@ -0,0 +1,14 @@
+#pragma once
+
+// STD
+#include <cstdint>
+#include <ostream>
+
+namespace Playground {
+	enum class SubmissionMode : uint8_t {
+		CPU, // Objects are batched on the CPU and drawn with one instanced draw per model
+		GPU, // Objects are culled in a compute shader and drawn with a single multi draw indirect
+	};
+}
+
+std::ostream& operator<<(std::ostream& os, const Playground::SubmissionMode mode);
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+// STD
+#include <vector>
+#include <cstdint>
+
+// glLoadGen
+#include <glloadgen/gl_core_4_5.h>
+
+namespace Playground {
+	// A decoded texture with its full mip chain, ready to be uploaded
+	class TextureData {
+		public:
+			GLenum format; // The sized internal format of the texture
+			bool compressed; // If the levels hold compressed blocks instead of RGBA8 texels
+			GLsizei width;
+			GLsizei height;
+			std::vector<std::vector<uint8_t>> levels; // From most to least detailed, empty if the texture failed to load
+	};
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+// STD
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Playground
+#include <Playground/TextureData.hpp>
+#include <Playground/TextureUsage.hpp>
+
+namespace Playground {
+	// Decodes an image, builds its mip chain and block compresses every level. Safe to call from any thread.
+	// The result is cached next to the image in a file named after the hash of its contents so later runs skip the encoding.
+	class TextureLoader {
+		public:
+			// Bump whenever the output of load changes so stale cache files are rebuilt
+			static constexpr uint32_t cacheVersion = 2;
+
+			// Loads a texture, the levels are empty if it couldn't be loaded
+			static TextureData load(const std::string& path, TextureUsage usage);
+
+		private:
+			static std::string getCachePath(const std::string& path, const std::string& contents, TextureUsage usage);
+			static bool readCache(const std::string& cachePath, TextureData& texture);
+			static void writeCache(const std::string& cachePath, const TextureData& texture);
+
+			// Builds the RGBA8 levels of an image with its most detailed level already in level zero
+			static void buildMipChain(TextureData& texture, TextureUsage usage);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+// STD
+#include <cstdint>
+#include <ostream>
+
+namespace Playground {
+	enum class TextureUsage : uint8_t {
+		COLOR, // sRGB color with alpha, mipmapped in linear space and stored as BC7
+		MASK, // A single linear channel, stored as BC4
+		NORMAL, // A tangent space normal map, stored as BC5 with the z component reconstructed in the shader
+	};
+}
+
+std::ostream& operator<<(std::ostream& os, const Playground::TextureUsage usage);
\ No newline at end of file
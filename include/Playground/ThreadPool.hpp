@@ -0,0 +1,54 @@
+#pragma once
+
+// STD
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace Playground {
+	// A fixed set of worker threads that run submitted tasks in order
+	class ThreadPool {
+		public:
+			ThreadPool(unsigned int threadCount = getDefaultThreadCount());
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+			~ThreadPool();
+
+			template<class Function>
+			auto submit(Function&& function) -> std::future<decltype(function())>;
+
+			unsigned int getThreadCount() const;
+
+			// One thread per core, leaving one for the render thread
+			static unsigned int getDefaultThreadCount();
+
+		private:
+			std::vector<std::thread> threads;
+			std::queue<std::function<void()>> tasks;
+			std::mutex mutex;
+			std::condition_variable condition;
+			bool stopping;
+
+			void work();
+	};
+
+	template<class Function>
+	auto ThreadPool::submit(Function&& function) -> std::future<decltype(function())> {
+		// std::function must be copyable so the task is shared instead of moved in
+		auto task = std::make_shared<std::packaged_task<decltype(function())()>>(std::forward<Function>(function));
+		auto future = task->get_future();
+
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			tasks.emplace([task]() { (*task)(); });
+		}
+
+		condition.notify_one();
+		return future;
+	}
+}
@@ -54,5 +54,6 @@ project "AA_Playground"
 		"include",
 		"dependencies/glfw/include",
 		"dependencies/tinyobjloader/include",
+		"dependencies/stb/include",
 		"dependencies/glm"
 	}
@@ -0,0 +1,81 @@
+// STD
+#include <chrono>
+#include <sstream>
+#include <algorithm>
+
+// Playground
+#include <Playground/AssetManager.hpp>
+
+namespace Playground {
+	AssetManager::AssetManager(GeometryArena& arena, ThreadPool& pool) :
+		arena{arena},
+		pool{pool},
+		materials{pool} {
+	}
+
+	AssetManager::~AssetManager() {
+		// Let any loads in flight finish before the models go away
+		for (auto& entry : pending) {
+			entry.loaded.wait();
+		}
+	}
+
+	std::shared_ptr<Model> AssetManager::getModel(const std::string& path, const float scale, glm::vec3 color) {
+		std::ostringstream key;
+		key << path << "|" << scale << "|" << color.r << "," << color.g << "," << color.b;
+
+		const auto found = models.find(key.str());
+
+		if (found != models.end()) {
+			return found->second;
+		}
+
+		// Start loading the model on a worker
+		auto model = std::make_shared<Model>(path, scale, color);
+		pending.push_back({model, pool.submit([model]() { model->load(); })});
+		models.emplace(key.str(), model);
+
+		return model;
+	}
+
+	void AssetManager::update() {
+		// Upload the models that have finished loading, get rethrows any errors from the worker
+		const auto finished = std::stable_partition(pending.begin(), pending.end(), [](PendingModel& entry) {
+			return entry.loaded.wait_for(std::chrono::seconds{0}) != std::future_status::ready;
+		});
+
+		for (auto it = finished; it != pending.end(); ++it) {
+			it->loaded.get();
+			it->model->upload(arena, materials);
+		}
+
+		pending.erase(finished, pending.end());
+		materials.update();
+	}
+
+	void AssetManager::wait(const std::shared_ptr<Model>& model) {
+		const auto found = std::find_if(pending.begin(), pending.end(), [&model](const PendingModel& entry) {
+			return entry.model == model;
+		});
+
+		if (found == pending.end()) {
+			return;
+		}
+
+		found->loaded.get();
+		found->model->upload(arena, materials);
+		pending.erase(found);
+	}
+
+	bool AssetManager::isLoading() const {
+		return !pending.empty() || materials.isLoading();
+	}
+
+	GeometryArena& AssetManager::getArena() {
+		return arena;
+	}
+
+	MaterialLibrary& AssetManager::getMaterials() {
+		return materials;
+	}
+}
\ No newline at end of file
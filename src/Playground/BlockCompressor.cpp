@@ -0,0 +1,278 @@
+// STD
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+// Playground
+#include <Playground/BlockCompressor.hpp>
+
+namespace {
+	// The interpolation weights of 4 bit BC7 indices, out of 64
+	constexpr int bc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+	// Writes bits least significant first into a block
+	class BitWriter {
+		public:
+			BitWriter(uint8_t* data) : data{data}, position{0} {
+			}
+
+			void write(uint32_t value, unsigned int count) {
+				for (unsigned int i = 0; i < count; ++i, ++position) {
+					data[position / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (position % 8));
+				}
+			}
+
+		private:
+			uint8_t* data;
+			unsigned int position;
+	};
+
+	// Finds the 7 bit value and shared p-bit that best reconstruct an endpoint as (value << 1) | pBit
+	void quantizeEndpoint(const float endpoint[4], uint8_t quantized[4], uint8_t& pBit) {
+		float bestError = -1.0f;
+
+		for (uint8_t p = 0; p < 2; ++p) {
+			uint8_t candidate[4];
+			float error = 0.0f;
+
+			for (int c = 0; c < 4; ++c) {
+				const float value = std::round((endpoint[c] - p) * 0.5f);
+				candidate[c] = static_cast<uint8_t>(std::min(std::max(value, 0.0f), 127.0f));
+
+				const float difference = static_cast<float>((candidate[c] << 1) | p) - endpoint[c];
+				error += difference * difference;
+			}
+
+			if (bestError < 0.0f || error < bestError) {
+				bestError = error;
+				std::memcpy(quantized, candidate, 4);
+				pBit = p;
+			}
+		}
+	}
+}
+
+namespace Playground {
+	std::vector<uint8_t> BlockCompressor::compress(const uint8_t* rgba, int width, int height, GLenum format) {
+		const int blocksX = (width + 3) / 4;
+		const int blocksY = (height + 3) / 4;
+		const size_t blockSize = getBlockSize(format);
+		std::vector<uint8_t> result(blocksX * blocksY * blockSize, 0);
+
+		uint8_t texels[16 * 4];
+		uint8_t channel[16];
+
+		for (int by = 0; by < blocksY; ++by) {
+			for (int bx = 0; bx < blocksX; ++bx) {
+				// Gather the block, clamping to the edge of the image
+				for (int y = 0; y < 4; ++y) {
+					for (int x = 0; x < 4; ++x) {
+						const int sx = std::min(bx * 4 + x, width - 1);
+						const int sy = std::min(by * 4 + y, height - 1);
+						std::memcpy(&texels[(y * 4 + x) * 4], &rgba[(sy * width + sx) * 4], 4);
+					}
+				}
+
+				uint8_t* block = &result[(by * blocksX + bx) * blockSize];
+
+				if (format == GL_COMPRESSED_RED_RGTC1 || format == GL_COMPRESSED_RG_RGTC2) {
+					// RGTC2 is two RGTC1 blocks, red then green
+					const int channelCount = format == GL_COMPRESSED_RED_RGTC1 ? 1 : 2;
+
+					for (int c = 0; c < channelCount; ++c) {
+						for (int i = 0; i < 16; ++i) {
+							channel[i] = texels[i * 4 + c];
+						}
+
+						encodeBC4(channel, block + c * 8);
+					}
+				} else {
+					encodeBC7(texels, block);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	size_t BlockCompressor::getBlockSize(GLenum format) {
+		return format == GL_COMPRESSED_RED_RGTC1 ? 8 : 16;
+	}
+
+	void BlockCompressor::encodeBC7(const uint8_t* texels, uint8_t* block) {
+		// Fit a line through the texels along their principal axis
+		float mean[4] = {};
+
+		for (int i = 0; i < 16; ++i) {
+			for (int c = 0; c < 4; ++c) {
+				mean[c] += texels[i * 4 + c] / 16.0f;
+			}
+		}
+
+		float covariance[4][4] = {};
+
+		for (int i = 0; i < 16; ++i) {
+			float offset[4];
+
+			for (int c = 0; c < 4; ++c) {
+				offset[c] = texels[i * 4 + c] - mean[c];
+			}
+
+			for (int a = 0; a < 4; ++a) {
+				for (int b = 0; b < 4; ++b) {
+					covariance[a][b] += offset[a] * offset[b];
+				}
+			}
+		}
+
+		// A few rounds of power iteration are plenty for a 4x4 matrix
+		float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+		for (int iteration = 0; iteration < 8; ++iteration) {
+			float next[4] = {};
+			float length = 0.0f;
+
+			for (int a = 0; a < 4; ++a) {
+				for (int b = 0; b < 4; ++b) {
+					next[a] += covariance[a][b] * axis[b];
+				}
+
+				length += next[a] * next[a];
+			}
+
+			if (length <= 0.0f) {
+				break;
+			}
+
+			length = 1.0f / std::sqrt(length);
+
+			for (int c = 0; c < 4; ++c) {
+				axis[c] = next[c] * length;
+			}
+		}
+
+		// Project the texels onto the axis to find the endpoints
+		float minT = 0.0f;
+		float maxT = 0.0f;
+
+		for (int i = 0; i < 16; ++i) {
+			float t = 0.0f;
+
+			for (int c = 0; c < 4; ++c) {
+				t += (texels[i * 4 + c] - mean[c]) * axis[c];
+			}
+
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		float endpoints[2][4];
+
+		for (int c = 0; c < 4; ++c) {
+			endpoints[0][c] = std::min(std::max(mean[c] + axis[c] * minT, 0.0f), 255.0f);
+			endpoints[1][c] = std::min(std::max(mean[c] + axis[c] * maxT, 0.0f), 255.0f);
+		}
+
+		uint8_t quantized[2][4];
+		uint8_t pBits[2];
+		quantizeEndpoint(endpoints[0], quantized[0], pBits[0]);
+		quantizeEndpoint(endpoints[1], quantized[1], pBits[1]);
+
+		// Build the palette the decoder will see and pick the closest entry for each texel
+		int palette[16][4];
+
+		for (int i = 0; i < 16; ++i) {
+			for (int c = 0; c < 4; ++c) {
+				const int e0 = (quantized[0][c] << 1) | pBits[0];
+				const int e1 = (quantized[1][c] << 1) | pBits[1];
+				palette[i][c] = ((64 - bc7Weights[i]) * e0 + bc7Weights[i] * e1 + 32) >> 6;
+			}
+		}
+
+		uint8_t indices[16];
+
+		for (int i = 0; i < 16; ++i) {
+			int bestError = -1;
+
+			for (uint8_t j = 0; j < 16; ++j) {
+				int error = 0;
+
+				for (int c = 0; c < 4; ++c) {
+					const int difference = palette[j][c] - texels[i * 4 + c];
+					error += difference * difference;
+				}
+
+				if (bestError < 0 || error < bestError) {
+					bestError = error;
+					indices[i] = j;
+				}
+			}
+		}
+
+		// The first index is stored without its top bit so it must be below 8, swapping the endpoints flips every index
+		if (indices[0] >= 8) {
+			std::swap(quantized[0], quantized[1]);
+			std::swap(pBits[0], pBits[1]);
+
+			for (auto& index : indices) {
+				index = 15 - index;
+			}
+		}
+
+		std::memset(block, 0, 16);
+		BitWriter writer{block};
+		writer.write(1 << 6, 7);
+
+		for (int c = 0; c < 4; ++c) {
+			writer.write(quantized[0][c], 7);
+			writer.write(quantized[1][c], 7);
+		}
+
+		writer.write(pBits[0], 1);
+		writer.write(pBits[1], 1);
+		writer.write(indices[0], 3);
+
+		for (int i = 1; i < 16; ++i) {
+			writer.write(indices[i], 4);
+		}
+	}
+
+	void BlockCompressor::encodeBC4(const uint8_t* values, uint8_t* block) {
+		const uint8_t maxValue = *std::max_element(values, values + 16);
+		const uint8_t minValue = *std::min_element(values, values + 16);
+
+		// With the first endpoint larger we get six interpolated values between them
+		int palette[8];
+		palette[0] = maxValue;
+		palette[1] = minValue;
+
+		for (int i = 1; i < 7; ++i) {
+			palette[i + 1] = ((7 - i) * maxValue + i * minValue) / 7;
+		}
+
+		uint64_t bits = 0;
+
+		for (int i = 0; i < 16; ++i) {
+			uint64_t bestIndex = 0;
+			int bestError = 256;
+
+			for (uint64_t j = 0; j < 8; ++j) {
+				const int error = std::abs(palette[j] - values[i]);
+
+				if (error < bestError) {
+					bestError = error;
+					bestIndex = j;
+				}
+			}
+
+			bits |= bestIndex << (3 * i);
+		}
+
+		block[0] = maxValue;
+		block[1] = minValue;
+
+		for (int i = 0; i < 6; ++i) {
+			block[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+// STD
+#include <string>
+#include <algorithm>
+
+// Playground
+#include <Playground/DepthPyramid.hpp>
+#include <Playground/GLState.hpp>
+
+namespace {
+	int previousPowerOfTwo(int value) {
+		int result = 1;
+
+		while (result * 2 <= value) {
+			result *= 2;
+		}
+
+		return result;
+	}
+}
+
+namespace Playground {
+	DepthPyramid::DepthPyramid(int depthWidth, int depthHeight) :
+		texture{0},
+		width{previousPowerOfTwo(depthWidth)},
+		height{previousPowerOfTwo(depthHeight)},
+		levelCount{1} {
+
+		while ((std::max(width, height) >> levelCount) > 0) {
+			++levelCount;
+		}
+
+		// Create the pyramid texture
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureStorage2D(texture, levelCount, GL_R32F, width, height);
+
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// Setup the reduction program
+		program = std::make_unique<ShaderProgram>(std::vector<ShaderProgram::Stage>{
+			{GL_COMPUTE_SHADER, "shaders/forward/depth_pyramid_comp.glsl"},
+		});
+	}
+
+	DepthPyramid::~DepthPyramid() {
+		glDeleteTextures(1, &texture);
+		GLState::invalidate();
+	}
+
+	bool DepthPyramid::isReady() {
+		return program->isReady();
+	}
+
+	void DepthPyramid::build(GLuint depthTexture) {
+		GLState::useProgram(program->getProgram());
+		const GLint sourceLevelLocation = program->getUniformLocation("sourceLevel");
+
+		for (int level = 0; level < levelCount; ++level) {
+			// The base level reduces the depth buffer, every other level reduces the level before it
+			const GLuint source = level == 0 ? depthTexture : texture;
+			const GLint sourceLevel = level == 0 ? 0 : level - 1;
+
+			GLState::bindTextureUnit(0, source);
+			glBindImageTexture(0, texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+			glUniform1i(sourceLevelLocation, sourceLevel);
+
+			const GLuint levelWidth = std::max(width >> level, 1);
+			const GLuint levelHeight = std::max(height >> level, 1);
+			glDispatchCompute((levelWidth + 7) / 8, (levelHeight + 7) / 8, 1);
+
+			// Make this level visible to the next reduction
+			glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+		}
+
+		GLState::bindTextureUnit(0, 0);
+	}
+
+	GLuint DepthPyramid::getTexture() const {
+		return texture;
+	}
+
+	int DepthPyramid::getWidth() const {
+		return width;
+	}
+
+	int DepthPyramid::getHeight() const {
+		return height;
+	}
+
+	int DepthPyramid::getLevelCount() const {
+		return levelCount;
+	}
+}
\ No newline at end of file
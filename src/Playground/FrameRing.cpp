@@ -0,0 +1,125 @@
+// STD
+#include <algorithm>
+
+// Playground
+#include <Playground/FrameRing.hpp>
+
+namespace Playground {
+	FrameRing::FrameRing(GLsizeiptr regionSize) :
+		buffer{0},
+		data{nullptr},
+		regionSize{0},
+		regionAlignment{1},
+		region{0},
+		head{0},
+		fences{},
+		retired{} {
+
+		// Every region starts on an offset that can be bound as any kind of buffer
+		GLint storageAlignment;
+		GLint uniformAlignment;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+		regionAlignment = std::max(storageAlignment, uniformAlignment);
+
+		createBuffer(regionSize);
+	}
+
+	FrameRing::~FrameRing() {
+		for (const auto fence : fences) {
+			if (fence != nullptr) {
+				glDeleteSync(fence);
+			}
+		}
+
+		for (const auto& entry : retired) {
+			if (entry.fence != nullptr) {
+				glDeleteSync(entry.fence);
+			}
+
+			deleteBuffer(entry.buffer);
+		}
+
+		deleteBuffer(buffer);
+	}
+
+	void FrameRing::beginFrame() {
+		region = (region + 1) % regionCount;
+		head = 0;
+
+		GLsync& fence = fences[region];
+
+		if (fence != nullptr) {
+			while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+			}
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		// Drop the buffers we outgrew once the last frame that used them is done, without waiting
+		retired.erase(std::remove_if(retired.begin(), retired.end(), [](const Retired& entry) {
+			if (entry.fence == nullptr || glClientWaitSync(entry.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+				return false;
+			}
+
+			glDeleteSync(entry.fence);
+			deleteBuffer(entry.buffer);
+			return true;
+		}), retired.end());
+	}
+
+	FrameRing::Allocation FrameRing::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+		// Align the offset into the buffer, regions only start on regionAlignment
+		const GLsizeiptr regionStart = static_cast<GLsizeiptr>(region) * regionSize;
+		GLsizeiptr offset = ((regionStart + head + alignment - 1) & ~(alignment - 1)) - regionStart;
+
+		if (offset + size > regionSize) {
+			// Earlier allocations of this frame still point into the old buffer so it is kept until this frame is done
+			retired.push_back({buffer, nullptr});
+
+			// Nothing in flight uses the new buffer so the fences of the old one no longer matter
+			for (auto& fence : fences) {
+				if (fence != nullptr) {
+					glDeleteSync(fence);
+					fence = nullptr;
+				}
+			}
+
+			createBuffer(std::max(size + alignment, 2 * regionSize));
+
+			const GLsizeiptr newRegionStart = static_cast<GLsizeiptr>(region) * regionSize;
+			offset = ((newRegionStart + alignment - 1) & ~(alignment - 1)) - newRegionStart;
+		}
+
+		head = offset + size;
+
+		const GLintptr bufferOffset = static_cast<GLintptr>(region) * regionSize + offset;
+		return {buffer, bufferOffset, data + bufferOffset};
+	}
+
+	void FrameRing::endFrame() {
+		fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		for (auto& entry : retired) {
+			if (entry.fence == nullptr) {
+				entry.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			}
+		}
+	}
+
+	void FrameRing::createBuffer(GLsizeiptr size) {
+		// Keep every region aligned so the offsets of allocations only depend on their own alignment
+		regionSize = (size + regionAlignment - 1) / regionAlignment * regionAlignment;
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, regionSize * regionCount, nullptr, flags);
+		data = static_cast<GLubyte*>(glMapNamedBufferRange(buffer, 0, regionSize * regionCount, flags));
+	}
+
+	void FrameRing::deleteBuffer(GLuint name) {
+		glUnmapNamedBuffer(name);
+		glDeleteBuffers(1, &name);
+	}
+}
\ No newline at end of file
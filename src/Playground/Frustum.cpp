@@ -0,0 +1,90 @@
+// SSE
+#include <xmmintrin.h>
+
+// Playground
+#include <Playground/Frustum.hpp>
+
+namespace Playground {
+	Frustum::Frustum(const glm::mat4& viewProjection) {
+		// Extract the planes from the rows of the view projection matrix (Gribb/Hartmann)
+		const auto row = [&viewProjection](int i) {
+			return glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+		};
+
+		planes[0] = row(3) + row(0); // Left
+		planes[1] = row(3) - row(0); // Right
+		planes[2] = row(3) + row(1); // Bottom
+		planes[3] = row(3) - row(1); // Top
+		planes[4] = row(3) + row(2); // Near
+		planes[5] = row(3) - row(2); // Far
+
+		for (auto& plane : planes) {
+			plane /= glm::length(glm::vec3{plane.x, plane.y, plane.z});
+		}
+	}
+
+	const std::array<glm::vec4, 6>& Frustum::getPlanes() const {
+		return planes;
+	}
+
+	size_t Frustum::cullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count, uint8_t* visible) const {
+		size_t visibleCount = 0;
+		size_t i = 0;
+
+		// Splat each plane across a register so that each lane can test a different sphere
+		__m128 planeX[6];
+		__m128 planeY[6];
+		__m128 planeZ[6];
+		__m128 planeW[6];
+
+		for (int p = 0; p < 6; ++p) {
+			planeX[p] = _mm_set1_ps(planes[p].x);
+			planeY[p] = _mm_set1_ps(planes[p].y);
+			planeZ[p] = _mm_set1_ps(planes[p].z);
+			planeW[p] = _mm_set1_ps(planes[p].w);
+		}
+
+		for (; i + 4 <= count; i += 4) {
+			const __m128 sphereX = _mm_loadu_ps(x + i);
+			const __m128 sphereY = _mm_loadu_ps(y + i);
+			const __m128 sphereZ = _mm_loadu_ps(z + i);
+			const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+			// A sphere is outside if it is entirely behind any plane
+			__m128 outside = _mm_setzero_ps();
+
+			for (int p = 0; p < 6; ++p) {
+				__m128 distance = _mm_mul_ps(sphereX, planeX[p]);
+				distance = _mm_add_ps(distance, _mm_mul_ps(sphereY, planeY[p]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(sphereZ, planeZ[p]));
+				distance = _mm_add_ps(distance, planeW[p]);
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+			}
+
+			const int outsideMask = _mm_movemask_ps(outside);
+
+			for (int lane = 0; lane < 4; ++lane) {
+				const uint8_t isVisible = ((outsideMask >> lane) & 1) ? 0 : 1;
+				visible[i + lane] = isVisible;
+				visibleCount += isVisible;
+			}
+		}
+
+		// Test any remaining spheres one at a time
+		for (; i < count; ++i) {
+			uint8_t isVisible = 1;
+
+			for (const auto& plane : planes) {
+				if (plane.x * x[i] + plane.y * y[i] + plane.z * z[i] + plane.w < -radius[i]) {
+					isVisible = 0;
+					break;
+				}
+			}
+
+			visible[i] = isVisible;
+			visibleCount += isVisible;
+		}
+
+		return visibleCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+// STD
+#include <array>
+#include <unordered_map>
+
+// Playground
+#include <Playground/GLState.hpp>
+
+namespace {
+	// Bindings are keyed by the enum GL would report them with, texture units by GL_TEXTURE0 + unit
+	class Cache {
+		public:
+			std::unordered_map<GLenum, GLuint> values;
+			std::array<GLint, 4> viewport;
+			bool viewportKnown;
+			Playground::GLState::Stats stats;
+	};
+
+	Cache& getCache() {
+		static Cache cache{{}, {}, false, {}};
+		return cache;
+	}
+
+	// Records the new value and returns if it has to be passed on to GL
+	bool change(GLenum key, GLuint value) {
+		auto& cache = getCache();
+		const auto found = cache.values.find(key);
+
+		if (found != cache.values.end() && found->second == value) {
+			++cache.stats.redundantCount;
+			return false;
+		}
+
+		cache.values[key] = value;
+		++cache.stats.callCount;
+		return true;
+	}
+}
+
+namespace Playground {
+	void GLState::useProgram(GLuint program) {
+		if (change(GL_CURRENT_PROGRAM, program)) {
+			glUseProgram(program);
+		}
+	}
+
+	void GLState::bindVertexArray(GLuint vao) {
+		if (change(GL_VERTEX_ARRAY_BINDING, vao)) {
+			glBindVertexArray(vao);
+		}
+	}
+
+	void GLState::bindFramebuffer(GLuint framebuffer) {
+		if (change(GL_FRAMEBUFFER_BINDING, framebuffer)) {
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		}
+	}
+
+	void GLState::bindBuffer(GLenum target, GLuint buffer) {
+		if (change(target, buffer)) {
+			glBindBuffer(target, buffer);
+		}
+	}
+
+	void GLState::bindTextureUnit(GLuint unit, GLuint texture) {
+		if (change(GL_TEXTURE0 + unit, texture)) {
+			glBindTextureUnit(unit, texture);
+		}
+	}
+
+	void GLState::setEnabled(GLenum capability, bool enabled) {
+		if (!change(capability, enabled)) {
+			return;
+		}
+
+		if (enabled) {
+			glEnable(capability);
+		} else {
+			glDisable(capability);
+		}
+	}
+
+	void GLState::depthMask(GLboolean mask) {
+		if (change(GL_DEPTH_WRITEMASK, mask)) {
+			glDepthMask(mask);
+		}
+	}
+
+	void GLState::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+		auto& cache = getCache();
+		const std::array<GLint, 4> viewport = {x, y, width, height};
+
+		if (cache.viewportKnown && cache.viewport == viewport) {
+			++cache.stats.redundantCount;
+			return;
+		}
+
+		cache.viewport = viewport;
+		cache.viewportKnown = true;
+		++cache.stats.callCount;
+		glViewport(x, y, width, height);
+	}
+
+	void GLState::invalidate() {
+		auto& cache = getCache();
+		cache.values.clear();
+		cache.viewportKnown = false;
+	}
+
+	const GLState::Stats& GLState::getStats() {
+		return getCache().stats;
+	}
+
+	void GLState::resetStats() {
+		getCache().stats = {};
+	}
+}
\ No newline at end of file
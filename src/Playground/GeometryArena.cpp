@@ -0,0 +1,125 @@
+// STD
+#include <cstddef>
+#include <algorithm>
+
+// Playground
+#include <Playground/GeometryArena.hpp>
+#include <Playground/GLState.hpp>
+
+namespace Playground {
+	GeometryArena::GeometryArena(GLuint vertexCapacity, GLuint indexCapacity) :
+		vao{0},
+		vbo{0},
+		ibo{0},
+		vertexCapacity{vertexCapacity},
+		vertexCount{0},
+		indexCapacity{indexCapacity},
+		indexCount{0} {
+
+		// Create the buffers
+		glCreateBuffers(1, &vbo);
+		glNamedBufferData(vbo, vertexCapacity * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+
+		glCreateBuffers(1, &ibo);
+		glNamedBufferData(ibo, indexCapacity * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+
+		// Create the vao
+		glCreateVertexArrays(1, &vao);
+		glVertexArrayVertexBuffer(vao, vertexBinding, vbo, 0, sizeof(Vertex));
+		glVertexArrayElementBuffer(vao, ibo);
+
+		// Setup the vertex attributes
+		const auto setupAttribute = [this](GLuint location, GLint size, GLuint offset) {
+			glEnableVertexArrayAttrib(vao, location);
+			glVertexArrayAttribFormat(vao, location, size, GL_FLOAT, GL_FALSE, offset);
+			glVertexArrayAttribBinding(vao, location, vertexBinding);
+		};
+
+		setupAttribute(positionLocation, 3, offsetof(Vertex, position));
+		setupAttribute(normalLocation, 3, offsetof(Vertex, normal));
+		setupAttribute(colorLocation, 3, offsetof(Vertex, color));
+		setupAttribute(texCoordLocation, 2, offsetof(Vertex, texcoord));
+
+		// Setup the per instance object index
+		glEnableVertexArrayAttrib(vao, instanceObjectLocation);
+		glVertexArrayAttribIFormat(vao, instanceObjectLocation, 1, GL_UNSIGNED_INT, 0);
+		glVertexArrayAttribBinding(vao, instanceObjectLocation, instanceBinding);
+
+		glVertexArrayBindingDivisor(vao, instanceBinding, 1);
+	}
+
+	GeometryArena::~GeometryArena() {
+		glDeleteVertexArrays(1, &vao);
+		glDeleteBuffers(1, &vbo);
+		glDeleteBuffers(1, &ibo);
+		GLState::invalidate();
+	}
+
+	MeshRange GeometryArena::allocate(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices) {
+		const GLuint newVertexCount = vertexCount + static_cast<GLuint>(vertices.size());
+		const GLuint newIndexCount = indexCount + static_cast<GLuint>(indices.size());
+
+		// Make sure we have room for the new geometry
+		if (newVertexCount > vertexCapacity) {
+			grow(vbo, vertexCapacity, vertexCount, newVertexCount, sizeof(Vertex));
+			glVertexArrayVertexBuffer(vao, vertexBinding, vbo, 0, sizeof(Vertex));
+		}
+
+		if (newIndexCount > indexCapacity) {
+			grow(ibo, indexCapacity, indexCount, newIndexCount, sizeof(GLuint));
+			glVertexArrayElementBuffer(vao, ibo);
+		}
+
+		// Upload the geometry
+		MeshRange range{indexCount, static_cast<GLuint>(indices.size()), static_cast<GLint>(vertexCount)};
+
+		if (!vertices.empty()) {
+			glNamedBufferSubData(vbo, vertexCount * sizeof(Vertex), vertices.size() * sizeof(Vertex), vertices.data());
+		}
+
+		if (!indices.empty()) {
+			glNamedBufferSubData(ibo, indexCount * sizeof(GLuint), indices.size() * sizeof(GLuint), indices.data());
+		}
+
+		vertexCount = newVertexCount;
+		indexCount = newIndexCount;
+
+		return range;
+	}
+
+	MeshRange GeometryArena::allocateIndices(const MeshRange& vertexSource, const std::vector<GLuint>& indices) {
+		MeshRange range = allocate({}, indices);
+		range.baseVertex = vertexSource.baseVertex;
+		return range;
+	}
+
+	void GeometryArena::setInstanceBuffer(GLuint buffer, GLintptr offset) {
+		glVertexArrayVertexBuffer(vao, instanceBinding, buffer, offset, sizeof(GLuint));
+	}
+
+	void GeometryArena::setElementBuffer(GLuint buffer) {
+		glVertexArrayElementBuffer(vao, buffer == 0 ? ibo : buffer);
+	}
+
+	GLuint GeometryArena::getVAO() const {
+		return vao;
+	}
+
+	void GeometryArena::grow(GLuint& buffer, GLuint& capacity, GLuint used, GLuint required, GLsizeiptr elementSize) {
+		while (capacity < required) {
+			capacity = std::max(capacity * 2, 1u);
+		}
+
+		// Copy the old contents into a larger buffer
+		GLuint newBuffer;
+		glCreateBuffers(1, &newBuffer);
+		glNamedBufferData(newBuffer, capacity * elementSize, nullptr, GL_STATIC_DRAW);
+
+		if (used > 0) {
+			glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, used * elementSize);
+		}
+
+		glDeleteBuffers(1, &buffer);
+		buffer = newBuffer;
+	}
+}
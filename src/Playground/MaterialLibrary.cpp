@@ -0,0 +1,346 @@
+// STD
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+// Playground
+#include <Playground/MaterialLibrary.hpp>
+#include <Playground/TextureLoader.hpp>
+#include <Playground/GLState.hpp>
+
+namespace Playground {
+	MaterialLibrary::MaterialLibrary(ThreadPool& pool) :
+		pool{pool},
+		materialBuffer{0},
+		materialsDirty{true},
+		uploadBuffer{0},
+		uploadData{nullptr},
+		uploadHead{0} {
+
+		glCreateBuffers(1, &materialBuffer);
+		materials.push_back({{1.0f, 1.0f, 1.0f, 1.0f}, noTexture, noTexture, noTexture, 0});
+		masked.push_back(false);
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &uploadBuffer);
+		glNamedBufferStorage(uploadBuffer, uploadBufferSize, nullptr, flags);
+		uploadData = static_cast<GLubyte*>(glMapNamedBufferRange(uploadBuffer, 0, uploadBufferSize, flags));
+	}
+
+	MaterialLibrary::~MaterialLibrary() {
+		// Let any loads in flight finish before the pool goes away
+		for (auto& entry : pending) {
+			if (entry.second.loaded.valid()) {
+				entry.second.loaded.wait();
+			}
+		}
+
+		for (const auto& upload : uploads) {
+			glDeleteSync(upload.fence);
+		}
+
+		glUnmapNamedBuffer(uploadBuffer);
+		glDeleteBuffers(1, &uploadBuffer);
+		glDeleteBuffers(1, &materialBuffer);
+
+		for (const auto& array : textureArrays) {
+			glDeleteTextures(1, &array.texture);
+		}
+
+		GLState::invalidate();
+	}
+
+	GLuint MaterialLibrary::add(const Material& material) {
+		MaterialData data{};
+		data.diffuse = {material.diffuse, material.opacity};
+		data.diffuseTexture = noTexture;
+		data.alphaTexture = noTexture;
+		data.normalTexture = noTexture;
+
+		materials.push_back(data);
+		masked.push_back(!material.alphaTexture.empty());
+		materialsDirty = true;
+
+		const auto index = static_cast<GLuint>(materials.size() - 1);
+
+		if (!material.diffuseTexture.empty()) {
+			requestTexture(material.diffuseTexture, TextureUsage::COLOR, index, &MaterialData::diffuseTexture);
+		}
+
+		if (!material.alphaTexture.empty()) {
+			requestTexture(material.alphaTexture, TextureUsage::MASK, index, &MaterialData::alphaTexture);
+		}
+
+		if (!material.normalTexture.empty()) {
+			requestTexture(material.normalTexture, TextureUsage::NORMAL, index, &MaterialData::normalTexture);
+		}
+
+		return index;
+	}
+
+	void MaterialLibrary::update() {
+		// Give every texture that finished loading a layer, its levels are uploaded below
+		for (auto it = pending.begin(); it != pending.end();) {
+			auto& entry = it->second;
+
+			if (!entry.loaded.valid() || entry.loaded.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+				++it;
+				continue;
+			}
+
+			entry.data = entry.loaded.get();
+			entry.texture = entry.data.levels.empty() ? noTexture : addLayer(entry.data);
+
+			// Remember failures as well so we only warn once
+			if (entry.texture == noTexture) {
+				textureLookup.emplace(it->first, noTexture);
+				it = pending.erase(it);
+				continue;
+			}
+
+			entry.nextLevel = static_cast<GLint>(entry.data.levels.size()) - 1;
+			++it;
+		}
+
+		// Always upload the smallest waiting level so every texture gets a rough version before any gets its details
+		GLsizeiptr uploaded = 0;
+
+		while (true) {
+			auto next = pending.end();
+
+			for (auto it = pending.begin(); it != pending.end(); ++it) {
+				const auto& entry = it->second;
+
+				if (entry.nextLevel >= 0 && (next == pending.end()
+					|| entry.data.levels[entry.nextLevel].size() < next->second.data.levels[next->second.nextLevel].size())) {
+					next = it;
+				}
+			}
+
+			if (next == pending.end()) {
+				break;
+			}
+
+			auto& entry = next->second;
+			const auto size = static_cast<GLsizeiptr>(entry.data.levels[entry.nextLevel].size());
+
+			if ((uploaded > 0 && uploaded + size > uploadBudget) || !uploadLevel(entry)) {
+				break;
+			}
+
+			uploaded += size;
+
+			if (entry.nextLevel < 0) {
+				textureLookup.emplace(next->first, entry.resident);
+				pending.erase(next);
+			}
+		}
+	}
+
+	void MaterialLibrary::bind(GLuint binding, GLuint firstUnit) {
+		if (materialsDirty) {
+			glNamedBufferData(materialBuffer, materials.size() * sizeof(MaterialData), materials.data(), GL_STATIC_DRAW);
+			materialsDirty = false;
+		}
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, materialBuffer);
+
+		for (GLuint i = 0; i < textureArrays.size(); ++i) {
+			GLState::bindTextureUnit(firstUnit + i, textureArrays[i].texture);
+		}
+	}
+
+	GLuint MaterialLibrary::getMaterialCount() const {
+		return static_cast<GLuint>(materials.size());
+	}
+
+	bool MaterialLibrary::isTransparent(GLuint material) const {
+		return materials[material].diffuse.a < 1.0f;
+	}
+
+	bool MaterialLibrary::isMasked(GLuint material) const {
+		return masked[material];
+	}
+
+	bool MaterialLibrary::isLoading() const {
+		return !pending.empty();
+	}
+
+	void MaterialLibrary::requestTexture(const std::string& path, TextureUsage usage, GLuint material, GLint MaterialData::* texture) {
+		const std::string key = path + "|" + std::to_string(static_cast<int>(usage));
+		const auto found = textureLookup.find(key);
+
+		if (found != textureLookup.end()) {
+			materials[material].*texture = found->second;
+			return;
+		}
+
+		// Share the load with every other material waiting on the same texture
+		const auto inserted = pending.emplace(key, PendingTexture{});
+		auto& entry = inserted.first->second;
+
+		if (inserted.second) {
+			entry.loaded = pool.submit([path, usage]() { return TextureLoader::load(path, usage); });
+			entry.texture = noTexture;
+			entry.nextLevel = -1;
+			entry.resident = noTexture;
+		}
+
+		// Use whatever levels have arrived so far
+		materials[material].*texture = entry.resident;
+		entry.waiters.push_back({material, texture});
+	}
+
+	void MaterialLibrary::setResident(PendingTexture& entry, GLint resident) {
+		entry.resident = resident;
+
+		for (const auto& waiter : entry.waiters) {
+			materials[waiter.material].*waiter.texture = resident;
+		}
+
+		materialsDirty = true;
+	}
+
+	bool MaterialLibrary::uploadLevel(PendingTexture& entry) {
+		const GLint level = entry.nextLevel;
+		auto& pixels = entry.data.levels[level];
+		const auto size = static_cast<GLsizeiptr>(pixels.size());
+		const void* source = pixels.data();
+		GLintptr offset = -1;
+
+		// Levels too large for the ring are copied by the driver straight from our memory
+		if (size <= uploadBufferSize) {
+			offset = allocateUpload(size);
+
+			// The GPU is still reading the whole ring, try again next update instead of waiting for it
+			if (offset < 0) {
+				return false;
+			}
+
+			std::copy(pixels.begin(), pixels.end(), uploadData + offset);
+			GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+			source = reinterpret_cast<const void*>(offset);
+		}
+
+		const GLuint texture = textureArrays[entry.texture >> 16].texture;
+		const GLint layer = entry.texture & 0xFFFF;
+		const GLsizei width = std::max(entry.data.width >> level, 1);
+		const GLsizei height = std::max(entry.data.height >> level, 1);
+
+		if (entry.data.compressed) {
+			glCompressedTextureSubImage3D(texture, level, 0, 0, layer, width, height, 1, entry.data.format, static_cast<GLsizei>(size), source);
+		} else {
+			glTextureSubImage3D(texture, level, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, source);
+		}
+
+		if (offset >= 0) {
+			GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			uploads.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), offset});
+		}
+
+		// The level lives on the GPU now
+		std::vector<uint8_t>{}.swap(pixels);
+		--entry.nextLevel;
+		setResident(entry, entry.texture | (level << 24));
+
+		return true;
+	}
+
+	GLintptr MaterialLibrary::allocateUpload(GLsizeiptr size) {
+		// Release the ranges the GPU has finished copying from without waiting on the rest
+		while (!uploads.empty() && glClientWaitSync(uploads.front().fence, 0, 0) != GL_TIMEOUT_EXPIRED) {
+			glDeleteSync(uploads.front().fence);
+			uploads.pop_front();
+		}
+
+		if (uploads.empty()) {
+			uploadHead = 0;
+		}
+
+		// Keep every level aligned for the copy
+		size = (size + 15) / 16 * 16;
+
+		// Everything from the oldest range in use up to the head is taken, wrapping around the end of the buffer
+		GLintptr offset = -1;
+
+		if (uploads.empty()) {
+			offset = size <= uploadBufferSize ? 0 : -1;
+		} else {
+			const GLintptr tail = uploads.front().offset;
+
+			if (uploadHead > tail) {
+				if (uploadHead + size <= uploadBufferSize) {
+					offset = uploadHead;
+				} else if (size <= tail) {
+					offset = 0;
+				}
+			} else if (uploadHead < tail && uploadHead + size <= tail) {
+				offset = uploadHead;
+			}
+		}
+
+		if (offset >= 0) {
+			uploadHead = offset + size;
+		}
+
+		return offset;
+	}
+
+	GLint MaterialLibrary::addLayer(const TextureData& data) {
+		const GLenum format = data.format;
+		const GLsizei width = data.width;
+		const GLsizei height = data.height;
+
+		auto array = std::find_if(textureArrays.begin(), textureArrays.end(), [&](const TextureArray& array) {
+			return array.format == format && array.width == width && array.height == height;
+		});
+
+		if (array == textureArrays.end()) {
+			if (textureArrays.size() == maxTextureArrays) {
+				std::cout << "[WARNING] More than " << maxTextureArrays << " texture sizes and formats are in use, ignoring a "
+					<< width << "x" << height << " texture.\n";
+				return noTexture;
+			}
+
+			// Every texture comes with its full mip chain so they all have the same number of levels
+			const auto levelCount = static_cast<GLsizei>(data.levels.size());
+			textureArrays.push_back({0, format, width, height, levelCount, 0, 0});
+			array = textureArrays.end() - 1;
+		}
+
+		if (array->layerCount == array->layerCapacity) {
+			growArray(*array, std::max(array->layerCapacity * 2, 4));
+		}
+
+		// The levels are uploaded later, a few at a time
+		const GLsizei layer = array->layerCount++;
+
+		return static_cast<GLint>(((array - textureArrays.begin()) << 16) | layer);
+	}
+
+	void MaterialLibrary::growArray(TextureArray& array, GLsizei layerCapacity) {
+		// Texture storage is immutable so we move the existing layers into a larger texture
+		GLuint texture;
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture);
+		glTextureStorage3D(texture, array.levelCount, array.format, array.width, array.height, layerCapacity);
+
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		if (array.texture != 0) {
+			for (GLsizei level = 0; level < array.levelCount; ++level) {
+				glCopyImageSubData(array.texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+					std::max(array.width >> level, 1), std::max(array.height >> level, 1), array.layerCount);
+			}
+
+			// The old array may still be bound to a texture unit
+			glDeleteTextures(1, &array.texture);
+			GLState::invalidate();
+		}
+
+		array.texture = texture;
+		array.layerCapacity = layerCapacity;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,365 @@
+// STD
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+// Playground
+#include <Playground/MeshSimplifier.hpp>
+
+namespace {
+	// Hashes the bits of a position so that we can find vertices that only differ in their other attributes
+	struct PositionHash {
+		size_t operator()(const glm::vec3& position) const {
+			const auto hashFloat = [](float value) {
+				// Treat -0 and 0 as the same position
+				return std::hash<float>{}(value == 0.0f ? 0.0f : value);
+			};
+
+			size_t hash = hashFloat(position.x);
+			hash = hash * 31 + hashFloat(position.y);
+			hash = hash * 31 + hashFloat(position.z);
+			return hash;
+		}
+	};
+
+	uint64_t edgeKey(GLuint a, GLuint b) {
+		return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+	}
+}
+
+namespace Playground {
+	void MeshSimplifier::Quadric::add(const Quadric& other) {
+		a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+		a11 += other.a11; a12 += other.a12; a13 += other.a13;
+		a22 += other.a22; a23 += other.a23;
+		a33 += other.a33;
+		weight += other.weight;
+	}
+
+	void MeshSimplifier::Quadric::addPlane(const glm::vec3& normal, double distance, double planeWeight) {
+		const double x = normal.x;
+		const double y = normal.y;
+		const double z = normal.z;
+
+		a00 += planeWeight * x * x; a01 += planeWeight * x * y; a02 += planeWeight * x * z; a03 += planeWeight * x * distance;
+		a11 += planeWeight * y * y; a12 += planeWeight * y * z; a13 += planeWeight * y * distance;
+		a22 += planeWeight * z * z; a23 += planeWeight * z * distance;
+		a33 += planeWeight * distance * distance;
+		weight += planeWeight;
+	}
+
+	double MeshSimplifier::Quadric::evaluate(const glm::vec3& point) const {
+		const double x = point.x;
+		const double y = point.y;
+		const double z = point.z;
+
+		// The weighted sum of squared distances to every plane, normalized to a mean by the total area
+		const double sum = a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x
+			+ a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y
+			+ a22 * z * z + 2.0 * a23 * z
+			+ a33;
+
+		return weight > 0.0 ? std::abs(sum) / weight : 0.0;
+	}
+
+	MeshSimplifier::MeshSimplifier(const std::vector<glm::vec3>& meshPositions, const std::vector<GLuint>& meshIndices) :
+		vertices{meshIndices},
+		result{meshIndices},
+		maxCost{0.0} {
+
+		// Work on only the vertices we use
+		std::sort(vertices.begin(), vertices.end());
+		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+		const GLuint vertexCount = static_cast<GLuint>(vertices.size());
+		positions.reserve(vertexCount);
+		indices.reserve(meshIndices.size());
+
+		for (const auto vertex : vertices) {
+			positions.push_back(meshPositions[vertex]);
+		}
+
+		for (const auto index : meshIndices) {
+			indices.push_back(static_cast<GLuint>(std::lower_bound(vertices.begin(), vertices.end(), index) - vertices.begin()));
+		}
+
+		// Find the vertices that share a position
+		std::unordered_map<glm::vec3, GLuint, PositionHash> uniquePositions;
+		wedges.resize(vertexCount);
+		seams.assign(vertexCount, false);
+
+		for (GLuint i = 0; i < vertexCount; ++i) {
+			const auto inserted = uniquePositions.emplace(positions[i], i);
+			wedges[i] = inserted.first->second;
+
+			if (!inserted.second) {
+				seams[wedges[i]] = true;
+			}
+		}
+
+		remap.resize(vertexCount);
+
+		for (GLuint i = 0; i < vertexCount; ++i) {
+			remap[i] = i;
+		}
+
+		// Accumulate the area weighted plane of every triangle into its corners
+		quadrics.assign(vertexCount, Quadric{});
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			const glm::vec3& p0 = positions[indices[i + 0]];
+			const glm::vec3& p1 = positions[indices[i + 1]];
+			const glm::vec3& p2 = positions[indices[i + 2]];
+
+			const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			const float length = glm::length(normal);
+
+			if (length <= 0.0f) {
+				continue;
+			}
+
+			const glm::vec3 unitNormal = normal / length;
+			const double distance = -glm::dot(unitNormal, p0);
+
+			for (size_t j = 0; j < 3; ++j) {
+				quadrics[wedges[indices[i + j]]].addPlane(unitNormal, distance, length * 0.5f);
+			}
+		}
+
+		// Lock the vertices of edges that are not shared by exactly two triangles
+		std::vector<uint64_t> edges;
+		edges.reserve(indices.size());
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			for (size_t j = 0; j < 3; ++j) {
+				const GLuint a = wedges[indices[i + j]];
+				const GLuint b = wedges[indices[i + (j + 1) % 3]];
+
+				if (a != b) {
+					edges.push_back(edgeKey(a, b));
+				}
+			}
+		}
+
+		std::sort(edges.begin(), edges.end());
+		locked = seams;
+
+		for (size_t i = 0; i < edges.size();) {
+			size_t j = i + 1;
+
+			while (j < edges.size() && edges[j] == edges[i]) {
+				++j;
+			}
+
+			if (j - i != 2) {
+				locked[static_cast<GLuint>(edges[i] >> 32)] = true;
+				locked[static_cast<GLuint>(edges[i] & 0xFFFFFFFF)] = true;
+			}
+
+			i = j;
+		}
+	}
+
+	bool MeshSimplifier::simplify(size_t targetIndexCount) {
+		bool collapsedAny = false;
+
+		while (indices.size() > targetIndexCount) {
+			const GLuint vertexCount = static_cast<GLuint>(positions.size());
+
+			// Build the triangles around each vertex
+			std::vector<GLuint> adjacencyOffsets(vertexCount + 1, 0);
+
+			for (const auto index : indices) {
+				++adjacencyOffsets[index + 1];
+			}
+
+			for (GLuint i = 0; i < vertexCount; ++i) {
+				adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+			}
+
+			std::vector<GLuint> adjacency(indices.size());
+			std::vector<GLuint> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+			for (size_t i = 0; i < indices.size(); ++i) {
+				adjacency[cursors[indices[i]]++] = static_cast<GLuint>(i / 3);
+			}
+
+			// Find the cheapest direction to collapse each edge in
+			std::vector<Collapse> collapses;
+			collapses.reserve(indices.size());
+
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				for (size_t j = 0; j < 3; ++j) {
+					const GLuint a = indices[i + j];
+					const GLuint b = indices[i + (j + 1) % 3];
+
+					// Only consider each edge from one of its triangles
+					if (a > b) {
+						continue;
+					}
+
+					const GLuint wedgeA = wedges[a];
+					const GLuint wedgeB = wedges[b];
+
+					Quadric quadric = quadrics[wedgeA];
+					quadric.add(quadrics[wedgeB]);
+
+					Collapse collapse{0, 0, -1.0};
+
+					// A vertex can only move if it is unlocked and can only land on a vertex that is not on a seam
+					if (!locked[wedgeA] && !seams[wedgeB]) {
+						collapse = {a, b, quadric.evaluate(positions[b])};
+					}
+
+					if (!locked[wedgeB] && !seams[wedgeA]) {
+						const double cost = quadric.evaluate(positions[a]);
+
+						if (collapse.cost < 0.0 || cost < collapse.cost) {
+							collapse = {b, a, cost};
+						}
+					}
+
+					if (collapse.cost >= 0.0) {
+						collapses.push_back(collapse);
+					}
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+				return a.cost < b.cost;
+			});
+
+			// Greedily apply the cheapest collapses that do not touch a vertex already changed this pass
+			std::vector<bool> touched(vertexCount, false);
+			size_t indexCount = indices.size();
+			bool collapsedPass = false;
+
+			for (const auto& collapse : collapses) {
+				if (indexCount <= targetIndexCount) {
+					break;
+				}
+
+				if (touched[collapse.from] || touched[collapse.to]) {
+					continue;
+				}
+
+				if (flipsTriangle(collapse.from, collapse.to, adjacency, adjacencyOffsets)) {
+					continue;
+				}
+
+				// Every triangle sharing the edge disappears
+				for (GLuint k = adjacencyOffsets[collapse.from]; k < adjacencyOffsets[collapse.from + 1]; ++k) {
+					const GLuint triangle = adjacency[k];
+
+					for (size_t j = 0; j < 3; ++j) {
+						if (resolve(indices[triangle * 3 + j]) == collapse.to) {
+							indexCount -= 3;
+							break;
+						}
+					}
+				}
+
+				remap[collapse.from] = collapse.to;
+				quadrics[wedges[collapse.to]].add(quadrics[wedges[collapse.from]]);
+				maxCost = std::max(maxCost, collapse.cost);
+
+				// Keep the neighbors fixed as well so the flip test above stays valid for the rest of the pass
+				for (GLuint k = adjacencyOffsets[collapse.from]; k < adjacencyOffsets[collapse.from + 1]; ++k) {
+					const GLuint triangle = adjacency[k];
+
+					for (size_t j = 0; j < 3; ++j) {
+						touched[indices[triangle * 3 + j]] = true;
+					}
+				}
+
+				collapsedPass = true;
+			}
+
+			if (!collapsedPass) {
+				break;
+			}
+
+			collapsedAny = true;
+
+			// Apply the collapses and remove the triangles that became degenerate
+			size_t write = 0;
+
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				const GLuint a = resolve(indices[i + 0]);
+				const GLuint b = resolve(indices[i + 1]);
+				const GLuint c = resolve(indices[i + 2]);
+
+				if (wedges[a] == wedges[b] || wedges[b] == wedges[c] || wedges[c] == wedges[a]) {
+					continue;
+				}
+
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+
+			indices.resize(write);
+		}
+
+		result.resize(indices.size());
+
+		for (size_t i = 0; i < indices.size(); ++i) {
+			result[i] = vertices[indices[i]];
+		}
+
+		return collapsedAny;
+	}
+
+	const std::vector<GLuint>& MeshSimplifier::getIndices() const {
+		return result;
+	}
+
+	float MeshSimplifier::getError() const {
+		return static_cast<float>(std::sqrt(maxCost));
+	}
+
+	GLuint MeshSimplifier::resolve(GLuint vertex) const {
+		while (remap[vertex] != vertex) {
+			vertex = remap[vertex];
+		}
+
+		return vertex;
+	}
+
+	bool MeshSimplifier::flipsTriangle(GLuint from, GLuint to, const std::vector<GLuint>& adjacency, const std::vector<GLuint>& adjacencyOffsets) const {
+		for (GLuint k = adjacencyOffsets[from]; k < adjacencyOffsets[from + 1]; ++k) {
+			const GLuint triangle = adjacency[k];
+			GLuint corners[3];
+			bool hasTo = false;
+
+			for (size_t j = 0; j < 3; ++j) {
+				corners[j] = resolve(indices[triangle * 3 + j]);
+				hasTo = hasTo || corners[j] == to;
+			}
+
+			// Triangles on the collapsed edge are removed rather than moved
+			if (hasTo) {
+				continue;
+			}
+
+			glm::vec3 before[3];
+			glm::vec3 after[3];
+
+			for (size_t j = 0; j < 3; ++j) {
+				before[j] = positions[corners[j]];
+				after[j] = positions[corners[j] == from ? to : corners[j]];
+			}
+
+			const glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+			const glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+			// Reject collapses that flip or heavily fold a triangle
+			if (glm::dot(normalBefore, normalAfter) <= 0.25f * glm::length(normalBefore) * glm::length(normalAfter)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
\ No newline at end of file
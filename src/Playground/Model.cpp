@@ -1,89 +1,341 @@
 // STD
+#include <cmath>
 #include <iostream>
+#include <algorithm>
+#include <unordered_map>
 
 // TinyObjLoader
 #include <tinyobjloader/tiny_obj_loader.h>
 
 // Playground
 #include <Playground/Model.hpp>
+#include <Playground/MeshSimplifier.hpp>
+
+namespace {
+	// Hashes the attribute indices of an obj vertex so that we can find duplicate vertices
+	struct IndexHash {
+		size_t operator()(const tinyobj::index_t& index) const {
+			size_t hash = std::hash<int>{}(index.vertex_index);
+			hash = hash * 31 + std::hash<int>{}(index.normal_index);
+			hash = hash * 31 + std::hash<int>{}(index.texcoord_index);
+			return hash;
+		}
+	};
+
+	struct IndexEqual {
+		bool operator()(const tinyobj::index_t& a, const tinyobj::index_t& b) const {
+			return a.vertex_index == b.vertex_index
+				&& a.normal_index == b.normal_index
+				&& a.texcoord_index == b.texcoord_index;
+		}
+	};
+}
 
 namespace Playground {
-	Model::Model(const std::string& path, const float scale, glm::vec3 color) : vao{0}, vbo{0}, count{0} {
+	Model::Model(const std::string& path, const float scale, glm::vec3 color) :
+		path{path},
+		scale{scale},
+		color{color},
+		ready{false},
+		mesh{0, 0, 0},
+		bounds{} {
+	};
 
+	Model::~Model() {
+	};
+
+	void Model::load() {
 		// Load the obj
-		std::vector<Playground::Vertex> data;
-		load(path, scale, color, data);
+		std::vector<std::vector<GLuint>> submeshIndices;
+		std::vector<int> submeshMaterials;
+		loadObj(submeshIndices, submeshMaterials);
+
+		// Keep the positions around for the CPU
+		positions.reserve(vertices.size());
+
+		for (const auto& vertex : vertices) {
+			positions.push_back(vertex.position);
+		}
+
+		// Store the submeshes back to back
+		for (const auto& submeshIndex : submeshIndices) {
+			indices.insert(indices.end(), submeshIndex.begin(), submeshIndex.end());
+		}
 
-		// Create vao
-		glGenVertexArrays(1, &vao);
-		glBindVertexArray(vao);
+		mesh = {0, static_cast<GLuint>(indices.size()), 0};
+		bounds = calculateBounds(indices);
 
-		// Create vbo
-		glGenBuffers(1, &vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(Playground::Vertex), &data[0], GL_STATIC_DRAW);
+		// Setup the submeshes, their ranges are relative to indices and lodIndices until we upload
+		constexpr GLuint unused = 0xFFFFFFFF;
+		std::vector<GLuint> localIndices(positions.size(), unused);
+		GLuint firstIndex = 0;
+		submeshes.resize(submeshIndices.size());
 
-		// Unbind
-		glBindVertexArray(0); // VAO should be unbound before buffers
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		for (size_t i = 0; i < submeshes.size(); ++i) {
+			auto& submesh = submeshes[i];
+			const GLuint count = static_cast<GLuint>(submeshIndices[i].size());
+
+			submesh.material = submeshMaterials[i];
+			submesh.bounds = calculateBounds(submeshIndices[i]);
+			submesh.lods.push_back({{firstIndex, count, 0}, 0.0f});
+			firstIndex += count;
+
+			generateLods(submesh, submeshIndices[i]);
+			buildMeshlets(submesh, submeshIndices[i], localIndices);
+		}
 	};
 
-	Model::~Model() {
-		glDeleteVertexArrays(1, &vao);
-		glDeleteBuffers(1, &vbo);
+	void Model::upload(GeometryArena& arena, MaterialLibrary& library) {
+		// Upload the most detailed levels along with the vertices and then every other level
+		mesh = arena.allocate(vertices, indices);
+		const MeshRange lodRange = lodIndices.empty() ? mesh : arena.allocateIndices(mesh, lodIndices);
+
+		// Add our materials to the library, faces without one use its default material
+		std::vector<GLuint> materialIds;
+
+		for (const auto& material : materials) {
+			materialIds.push_back(library.add(material));
+		}
+
+		for (auto& submesh : submeshes) {
+			const bool hasMaterial = submesh.material >= 0 && static_cast<size_t>(submesh.material) < materialIds.size();
+			submesh.materialId = hasMaterial ? materialIds[submesh.material] : MaterialLibrary::defaultMaterial;
+
+			for (size_t i = 0; i < submesh.lods.size(); ++i) {
+				submesh.lods[i].mesh.firstIndex += i == 0 ? mesh.firstIndex : lodRange.firstIndex;
+				submesh.lods[i].mesh.baseVertex = mesh.baseVertex;
+			}
+		}
+
+		// Free what only the GPU needs
+		std::vector<Vertex>().swap(vertices);
+		std::vector<GLuint>().swap(lodIndices);
+
+		ready = true;
 	};
 
-	void Model::setupForUseWith(GLuint program) {
-		glBindVertexArray(vao);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	bool Model::isReady() const {
+		return ready;
+	};
 
-		// Setup the vertex attributes
-		GLint vertPosition = glGetAttribLocation(program, "vertPosition");
-		GLint vertNormal = glGetAttribLocation(program, "vertNormal");
-		GLint vertColor = glGetAttribLocation(program, "vertColor");
-		GLint vertTexCoord = glGetAttribLocation(program, "vertTexCoord");
+	const std::string& Model::getPath() const {
+		return path;
+	};
+
+	const MeshRange& Model::getMesh() const {
+		return mesh;
+	};
+
+	const Bounds& Model::getBounds() const {
+		return bounds;
+	};
+
+	GLuint Model::getCount() const {
+		return mesh.count;
+	};
+
+	const std::vector<Submesh>& Model::getSubmeshes() const {
+		return submeshes;
+	};
+
+	const std::vector<Material>& Model::getMaterials() const {
+		return materials;
+	};
+
+	const std::vector<glm::vec3>& Model::getPositions() const {
+		return positions;
+	};
+
+	const std::vector<GLuint>& Model::getIndices() const {
+		return indices;
+	};
+
+	Bounds Model::calculateBounds(const std::vector<GLuint>& indices) const {
+		Bounds result{};
 
-		if (vertPosition > -1) {
-			glEnableVertexAttribArray(vertPosition);
-			glVertexAttribPointer(vertPosition, 3, GL_FLOAT, GL_FALSE, sizeof(Playground::Vertex), reinterpret_cast<GLvoid*>(offsetof(Playground::Vertex, position)));
+		if (indices.empty()) {
+			return result;
 		}
 
-		if (vertNormal > -1) {
-			glEnableVertexAttribArray(vertNormal);
-			glVertexAttribPointer(vertNormal, 3, GL_FLOAT, GL_FALSE, sizeof(Playground::Vertex), reinterpret_cast<GLvoid*>(offsetof(Playground::Vertex, normal)));
+		// Find the axis aligned bounds of the referenced vertices and center the sphere on them
+		glm::vec3 min = positions[indices[0]];
+		glm::vec3 max = positions[indices[0]];
+
+		for (const auto index : indices) {
+			min = glm::min(min, positions[index]);
+			max = glm::max(max, positions[index]);
 		}
 
-		if (vertColor > -1) {
-			glEnableVertexAttribArray(vertColor);
-			glVertexAttribPointer(vertColor, 3, GL_FLOAT, GL_FALSE, sizeof(Playground::Vertex), reinterpret_cast<GLvoid*>(offsetof(Playground::Vertex, color)));
+		result.min = min;
+		result.max = max;
+		result.center = (min + max) * 0.5f;
+		result.radius = 0.0f;
+
+		for (const auto index : indices) {
+			result.radius = std::max(result.radius, glm::distance(result.center, positions[index]));
 		}
 
-		if (vertTexCoord > -1) {
-			glEnableVertexAttribArray(vertTexCoord);
-			glVertexAttribPointer(vertTexCoord, 2, GL_FLOAT, GL_FALSE, sizeof(Playground::Vertex), reinterpret_cast<GLvoid*>(offsetof(Playground::Vertex, texcoord)));
+		return result;
+	};
+
+	void Model::generateLods(Submesh& submesh, const std::vector<GLuint>& indices) {
+		// Don't bother simplifying meshes that are already tiny
+		constexpr size_t minIndexCount = 3 * 32;
+
+		auto& lods = submesh.lods;
+		MeshSimplifier simplifier{positions, indices};
+		size_t targetIndexCount = indices.size();
+
+		while (lods.size() < maxLodCount) {
+			// Aim for half of the triangles of the previous level
+			targetIndexCount = targetIndexCount / 6 * 3;
+
+			if (targetIndexCount < minIndexCount || !simplifier.simplify(targetIndexCount)) {
+				break;
+			}
+
+			// Stop once simplification stops making meaningful progress
+			const auto& simplifiedIndices = simplifier.getIndices();
+
+			if (simplifiedIndices.size() * 4 > lods.back().mesh.count * 3) {
+				break;
+			}
+
+			lods.push_back({{static_cast<GLuint>(lodIndices.size()), static_cast<GLuint>(simplifiedIndices.size()), 0}, simplifier.getError()});
+			lodIndices.insert(lodIndices.end(), simplifiedIndices.begin(), simplifiedIndices.end());
+			targetIndexCount = simplifiedIndices.size();
 		}
+	};
 
-		// Unbind
-		glBindVertexArray(0); // VAO should be unbound before buffers
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-	}
+	void Model::buildMeshlets(Submesh& submesh, const std::vector<GLuint>& indices, std::vector<GLuint>& localIndices) {
+		// The index of each vertex inside of the meshlet being built, unused vertices are all ones
+		constexpr GLuint unused = 0xFFFFFFFF;
+		auto& meshletVertices = submesh.meshletVertices;
+		auto& meshletTriangles = submesh.meshletTriangles;
+		Meshlet meshlet{};
+
+		// Greedily group consecutive triangles, the face order of an obj usually keeps them close together
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			GLuint newVertices = 0;
+
+			for (size_t j = 0; j < 3; ++j) {
+				const GLuint vertex = indices[i + j];
+				const bool repeated = (j > 0 && indices[i] == vertex) || (j > 1 && indices[i + 1] == vertex);
+				newVertices += localIndices[vertex] == unused && !repeated;
+			}
+
+			// Start a new meshlet once this one is full
+			if (meshlet.vertexCount + newVertices > Meshlet::maxVertices || meshlet.triangleCount == Meshlet::maxTriangles) {
+				for (GLuint j = 0; j < meshlet.vertexCount; ++j) {
+					localIndices[meshletVertices[meshlet.vertexOffset + j]] = unused;
+				}
+
+				finishMeshlet(submesh, meshlet);
+				meshlet = {};
+				meshlet.vertexOffset = static_cast<GLuint>(meshletVertices.size());
+				meshlet.triangleOffset = static_cast<GLuint>(meshletTriangles.size());
+			}
+
+			// Add the triangle
+			GLuint triangle = 0;
+
+			for (size_t j = 0; j < 3; ++j) {
+				const GLuint vertex = indices[i + j];
+
+				if (localIndices[vertex] == unused) {
+					localIndices[vertex] = meshlet.vertexCount++;
+					meshletVertices.push_back(vertex);
+				}
+
+				triangle |= localIndices[vertex] << (8 * j);
+			}
+
+			meshletTriangles.push_back(triangle);
+			++meshlet.triangleCount;
+		}
 
-	GLuint Model::getVAO() {
-		return vao;
+		if (meshlet.triangleCount > 0) {
+			for (GLuint j = 0; j < meshlet.vertexCount; ++j) {
+				localIndices[meshletVertices[meshlet.vertexOffset + j]] = unused;
+			}
+
+			finishMeshlet(submesh, meshlet);
+		}
 	};
 
-	GLuint Model::getCount() {
-		return count;
+	void Model::finishMeshlet(Submesh& submesh, Meshlet& meshlet) {
+		const auto& meshletVertices = submesh.meshletVertices;
+		const auto& meshletTriangles = submesh.meshletTriangles;
+
+		// Bounding sphere
+		glm::vec3 min = positions[meshletVertices[meshlet.vertexOffset]];
+		glm::vec3 max = min;
+
+		for (GLuint i = 0; i < meshlet.vertexCount; ++i) {
+			const auto& position = positions[meshletVertices[meshlet.vertexOffset + i]];
+			min = glm::min(min, position);
+			max = glm::max(max, position);
+		}
+
+		meshlet.center = (min + max) * 0.5f;
+		meshlet.radius = 0.0f;
+
+		for (GLuint i = 0; i < meshlet.vertexCount; ++i) {
+			meshlet.radius = std::max(meshlet.radius, glm::distance(meshlet.center, positions[meshletVertices[meshlet.vertexOffset + i]]));
+		}
+
+		// Normal cone
+		std::vector<glm::vec3> normals;
+		normals.reserve(meshlet.triangleCount);
+
+		for (GLuint i = 0; i < meshlet.triangleCount; ++i) {
+			const GLuint triangle = meshletTriangles[meshlet.triangleOffset + i];
+			const auto& p0 = positions[meshletVertices[meshlet.vertexOffset + (triangle & 0xFF)]];
+			const auto& p1 = positions[meshletVertices[meshlet.vertexOffset + ((triangle >> 8) & 0xFF)]];
+			const auto& p2 = positions[meshletVertices[meshlet.vertexOffset + ((triangle >> 16) & 0xFF)]];
+			const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			const float length = glm::length(normal);
+
+			if (length > 0.0f) {
+				normals.push_back(normal / length);
+			}
+		}
+
+		glm::vec3 axis{0.0f, 0.0f, 0.0f};
+
+		for (const auto& normal : normals) {
+			axis += normal;
+		}
+
+		const float axisLength = glm::length(axis);
+		float minDot = 1.0f;
+
+		if (axisLength > 0.0f) {
+			axis /= axisLength;
+
+			for (const auto& normal : normals) {
+				minDot = std::min(minDot, glm::dot(axis, normal));
+			}
+		}
+
+		// Cones wider than a hemisphere always have a front facing triangle
+		meshlet.coneAxis = axis;
+		meshlet.coneCutoff = (axisLength > 0.0f && minDot > 0.0f) ? std::sqrt(1.0f - minDot * minDot) : 1.0f;
+
+		submesh.meshlets.push_back(meshlet);
 	};
 
-	void Model::load(const std::string& path, const float scale, glm::vec3 color, std::vector<Playground::Vertex>& data) {
+	void Model::loadObj(std::vector<std::vector<GLuint>>& submeshIndices, std::vector<int>& submeshMaterials) {
 		tinyobj::attrib_t attrib;
 		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
+		std::vector<tinyobj::material_t> objMaterials;
 		std::string error;
 
+		// Material libraries and textures are relative to the obj
+		const std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+
 		// Load the obj
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &error, path.c_str())) {
+		if (!tinyobj::LoadObj(&attrib, &shapes, &objMaterials, &error, path.c_str(), directory.c_str())) {
 			throw std::runtime_error("TinyObjLoader was unable to load \"" + path + "\" with error: " + error);
 		}
 
@@ -92,9 +344,55 @@ namespace Playground {
 			std::cerr << error << std::endl;
 		}
 
-		// Load the obj into data
+		// Keep the materials, textures are loaded on upload
+		const auto texturePath = [&directory](std::string name) {
+			if (name.empty()) {
+				return name;
+			}
+
+			std::replace(name.begin(), name.end(), '\\', '/');
+			return directory + name;
+		};
+
+		for (const auto& objMaterial : objMaterials) {
+			materials.push_back({
+				objMaterial.name,
+				{objMaterial.diffuse[0], objMaterial.diffuse[1], objMaterial.diffuse[2]},
+				objMaterial.dissolve,
+				texturePath(objMaterial.diffuse_texname),
+				texturePath(objMaterial.alpha_texname),
+				texturePath(objMaterial.bump_texname),
+			});
+		}
+
+		// Load the obj into vertices and indices, reusing vertices that share all of their attributes.
+		// The faces of each shape are split into one submesh per material.
+		std::unordered_map<tinyobj::index_t, GLuint, IndexHash, IndexEqual> uniqueVertices;
+
 		for (const auto& shape : shapes) {
-			for (const auto& index : shape.mesh.indices) {
+			std::unordered_map<int, size_t> shapeSubmeshes;
+
+			for (size_t i = 0; i < shape.mesh.indices.size(); ++i) {
+				const auto& index = shape.mesh.indices[i];
+
+				// The obj is triangulated while loading so every face has three indices
+				const size_t face = i / 3;
+				const int material = face < shape.mesh.material_ids.size() ? shape.mesh.material_ids[face] : -1;
+				const auto submesh = shapeSubmeshes.emplace(material, submeshIndices.size());
+
+				if (submesh.second) {
+					submeshIndices.emplace_back();
+					submeshMaterials.push_back(material);
+				}
+
+				auto& indices = submeshIndices[submesh.first->second];
+				const auto found = uniqueVertices.find(index);
+
+				if (found != uniqueVertices.end()) {
+					indices.push_back(found->second);
+					continue;
+				}
+
 				Playground::Vertex vertex{};
 				
 				// Positions
@@ -135,8 +433,9 @@ namespace Playground {
 					vertex.texcoord = {0.0f, 0.0f};
 				}
 				
-				data.push_back(vertex);
-				++count;
+				uniqueVertices.emplace(index, static_cast<GLuint>(vertices.size()));
+				indices.push_back(static_cast<GLuint>(vertices.size()));
+				vertices.push_back(vertex);
 			}
 		}
 	}
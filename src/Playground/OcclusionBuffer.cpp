@@ -0,0 +1,368 @@
+// STD
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+// SSE
+#include <xmmintrin.h>
+
+// Playground
+#include <Playground/OcclusionBuffer.hpp>
+
+namespace Playground {
+	OcclusionBuffer::OcclusionBuffer(int width, int height, ThreadPool& pool) :
+		width{width},
+		height{height},
+		pitch{(width + 3) & ~3},
+		tilesX{(width + tileSize - 1) / tileSize},
+		tilesY{(height + tileSize - 1) / tileSize},
+		pool{pool},
+		depth(pitch * height, 1.0f),
+		tileDepth(tilesX * tilesY, 1.0f),
+		chunkCount{0} {
+	}
+
+	void OcclusionBuffer::begin(const glm::mat4& viewProjection) {
+		this->viewProjection = viewProjection;
+		occluders.clear();
+		ranges.clear();
+		std::fill(depth.begin(), depth.end(), 1.0f);
+		std::fill(tileDepth.begin(), tileDepth.end(), 1.0f);
+	}
+
+	void OcclusionBuffer::addOccluder(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& indices, const glm::mat4& modelMatrix) {
+		addOccluder(positions, indices, modelMatrix, 0, indices.size());
+	}
+
+	void OcclusionBuffer::addOccluder(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& indices, const glm::mat4& modelMatrix, size_t firstIndex, size_t indexCount) {
+		const glm::mat4 modelViewProjection = viewProjection * modelMatrix;
+
+		if (occluders.empty() || occluders.back().positions != &positions || occluders.back().indices != &indices || occluders.back().modelViewProjection != modelViewProjection) {
+			occluders.push_back({&positions, &indices, modelViewProjection, 0, ranges.size(), 0});
+		}
+
+		ranges.push_back({firstIndex, indexCount - indexCount % 3});
+		++occluders.back().rangeCount;
+	}
+
+	void OcclusionBuffer::rasterize() {
+		std::vector<std::future<void>> tasks;
+
+		// Transform every vertex into clip space, large occluders are split so they are spread over the pool
+		size_t clipCount = 0;
+
+		for (auto& occluder : occluders) {
+			occluder.firstClipPosition = clipCount;
+			clipCount += occluder.positions->size();
+		}
+
+		clipPositions.resize(clipCount);
+
+		for (const auto& occluder : occluders) {
+			for (size_t first = 0; first < occluder.positions->size(); first += vertexChunkSize) {
+				const size_t last = std::min(first + vertexChunkSize, occluder.positions->size());
+				tasks.push_back(pool.submit([this, &occluder, first, last]() { transformVertices(occluder, first, last); }));
+			}
+		}
+
+		for (auto& task : tasks) {
+			task.get();
+		}
+
+		tasks.clear();
+
+		// Setup the triangles in chunks, each chunk bins its triangles so a band only visits the triangles that touch it
+		chunkCount = 0;
+
+		for (const auto& occluder : occluders) {
+			for (size_t i = occluder.firstRange; i < occluder.firstRange + occluder.rangeCount; ++i) {
+				const size_t lastIndex = ranges[i].firstIndex + ranges[i].indexCount;
+
+				for (size_t first = ranges[i].firstIndex; first < lastIndex; first += 3 * triangleChunkSize) {
+					if (chunkCount == chunks.size()) {
+						chunks.emplace_back();
+					}
+
+					auto& chunk = chunks[chunkCount++];
+					chunk.occluder = &occluder;
+					chunk.firstIndex = first;
+					chunk.lastIndex = std::min(first + 3 * triangleChunkSize, lastIndex);
+				}
+			}
+		}
+
+		for (size_t i = 0; i < chunkCount; ++i) {
+			auto& chunk = chunks[i];
+			tasks.push_back(pool.submit([this, &chunk]() { setupTriangles(chunk); }));
+		}
+
+		for (auto& task : tasks) {
+			task.get();
+		}
+
+		tasks.clear();
+
+		// Each band is a row of tiles so that a band can also reduce its own tile depths
+		for (int tileY = 0; tileY < tilesY; ++tileY) {
+			tasks.push_back(pool.submit([this, tileY]() { rasterizeBand(tileY); }));
+		}
+
+		for (auto& task : tasks) {
+			task.get();
+		}
+
+		occluders.clear();
+		ranges.clear();
+	}
+
+	void OcclusionBuffer::transformVertices(const Occluder& occluder, size_t first, size_t last) {
+		const auto& positions = *occluder.positions;
+		glm::vec4* clip = &clipPositions[occluder.firstClipPosition];
+
+		for (size_t i = first; i < last; ++i) {
+			clip[i] = occluder.modelViewProjection * glm::vec4{positions[i], 1.0f};
+		}
+	}
+
+	void OcclusionBuffer::setupTriangles(SetupChunk& chunk) {
+		const auto& indices = *chunk.occluder->indices;
+		const glm::vec4* clipPositions = &this->clipPositions[chunk.occluder->firstClipPosition];
+
+		chunk.triangles.clear();
+		chunk.bins.resize(tilesY);
+
+		for (auto& bin : chunk.bins) {
+			bin.clear();
+		}
+
+		for (size_t i = chunk.firstIndex; i < chunk.lastIndex; i += 3) {
+			const glm::vec4* clip[3] = {
+				&clipPositions[indices[i + 0]],
+				&clipPositions[indices[i + 1]],
+				&clipPositions[indices[i + 2]],
+			};
+
+			// Skip triangles that cross the near plane. Dropping occluder triangles only ever makes the buffer more conservative.
+			if (clip[0]->w <= clip[0]->z * -1.0f || clip[1]->w <= clip[1]->z * -1.0f || clip[2]->w <= clip[2]->z * -1.0f) {
+				continue;
+			}
+
+			// Project into window space
+			glm::vec3 screen[3];
+
+			for (int v = 0; v < 3; ++v) {
+				const float invW = 1.0f / clip[v]->w;
+				screen[v] = {
+					(clip[v]->x * invW * 0.5f + 0.5f) * width,
+					(clip[v]->y * invW * 0.5f + 0.5f) * height,
+					clip[v]->z * invW * 0.5f + 0.5f,
+				};
+			}
+
+			// Skip back facing and degenerate triangles
+			const float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+
+			if (area <= 0.0f) {
+				continue;
+			}
+
+			// Find the pixels whose centers may be covered
+			Triangle triangle;
+			triangle.minX = std::max(static_cast<int>(std::floor(std::min({screen[0].x, screen[1].x, screen[2].x}))), 0);
+			triangle.minY = std::max(static_cast<int>(std::floor(std::min({screen[0].y, screen[1].y, screen[2].y}))), 0);
+			triangle.maxX = std::min(static_cast<int>(std::ceil(std::max({screen[0].x, screen[1].x, screen[2].x}))), width - 1);
+			triangle.maxY = std::min(static_cast<int>(std::ceil(std::max({screen[0].y, screen[1].y, screen[2].y}))), height - 1);
+
+			if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+				continue;
+			}
+
+			// Setup the edge functions, each is positive on the inside of its edge
+			for (int e = 0; e < 3; ++e) {
+				const auto& a = screen[(e + 1) % 3];
+				const auto& b = screen[(e + 2) % 3];
+
+				triangle.edgeX[e] = a.y - b.y;
+				triangle.edgeY[e] = b.x - a.x;
+				triangle.edgeC[e] = a.x * b.y - a.y * b.x;
+			}
+
+			// Setup the depth plane from the barycentric weights of each edge
+			const float invArea = 1.0f / area;
+			triangle.depth = {
+				(triangle.edgeX[0] * screen[0].z + triangle.edgeX[1] * screen[1].z + triangle.edgeX[2] * screen[2].z) * invArea,
+				(triangle.edgeY[0] * screen[0].z + triangle.edgeY[1] * screen[1].z + triangle.edgeY[2] * screen[2].z) * invArea,
+				(triangle.edgeC[0] * screen[0].z + triangle.edgeC[1] * screen[1].z + triangle.edgeC[2] * screen[2].z) * invArea,
+			};
+
+			// Add the triangle to the bin of every band its rows overlap
+			const GLuint index = static_cast<GLuint>(chunk.triangles.size());
+			chunk.triangles.push_back(triangle);
+
+			for (int tileY = triangle.minY / tileSize; tileY <= triangle.maxY / tileSize; ++tileY) {
+				chunk.bins[tileY].push_back(index);
+			}
+		}
+	}
+
+	void OcclusionBuffer::rasterizeBand(int tileY) {
+		const int bandMinY = tileY * tileSize;
+		const int bandMaxY = std::min(bandMinY + tileSize, height);
+		const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+		for (size_t c = 0; c < chunkCount; ++c) {
+			const auto& chunk = chunks[c];
+
+			for (const auto index : chunk.bins[tileY]) {
+				const auto& triangle = chunk.triangles[index];
+				const int minY = std::max(triangle.minY, bandMinY);
+				const int maxY = std::min(triangle.maxY, bandMaxY - 1);
+
+				const __m128 edgeX0 = _mm_set1_ps(triangle.edgeX[0]);
+				const __m128 edgeX1 = _mm_set1_ps(triangle.edgeX[1]);
+				const __m128 edgeX2 = _mm_set1_ps(triangle.edgeX[2]);
+				const __m128 depthX = _mm_set1_ps(triangle.depth.x);
+				const int startX = triangle.minX & ~3;
+
+				for (int y = minY; y <= maxY; ++y) {
+					const float centerY = y + 0.5f;
+
+					// The parts of each function that are constant along the row
+					const __m128 rowEdge0 = _mm_set1_ps(triangle.edgeY[0] * centerY + triangle.edgeC[0]);
+					const __m128 rowEdge1 = _mm_set1_ps(triangle.edgeY[1] * centerY + triangle.edgeC[1]);
+					const __m128 rowEdge2 = _mm_set1_ps(triangle.edgeY[2] * centerY + triangle.edgeC[2]);
+					const __m128 rowDepth = _mm_set1_ps(triangle.depth.y * centerY + triangle.depth.z);
+
+					float* row = &depth[y * pitch];
+
+					for (int x = startX; x <= triangle.maxX; x += 4) {
+						const __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+						const __m128 edge0 = _mm_add_ps(_mm_mul_ps(edgeX0, centerX), rowEdge0);
+						const __m128 edge1 = _mm_add_ps(_mm_mul_ps(edgeX1, centerX), rowEdge1);
+						const __m128 edge2 = _mm_add_ps(_mm_mul_ps(edgeX2, centerX), rowEdge2);
+
+						// A pixel is covered when no edge function is negative
+						const __m128 outside = _mm_or_ps(_mm_or_ps(
+							_mm_cmplt_ps(edge0, _mm_setzero_ps()),
+							_mm_cmplt_ps(edge1, _mm_setzero_ps())),
+							_mm_cmplt_ps(edge2, _mm_setzero_ps()));
+
+						if (_mm_movemask_ps(outside) == 0xF) {
+							continue;
+						}
+
+						// Keep the nearest depth of the covered pixels
+						const __m128 pixelDepth = _mm_add_ps(_mm_mul_ps(depthX, centerX), rowDepth);
+						const __m128 oldDepth = _mm_loadu_ps(row + x);
+						const __m128 newDepth = _mm_min_ps(oldDepth, pixelDepth);
+
+						_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(outside, oldDepth), _mm_andnot_ps(outside, newDepth)));
+					}
+				}
+			}
+		}
+
+		// Find the farthest depth of each tile in this band
+		for (int tileX = 0; tileX < tilesX; ++tileX) {
+			const int minX = tileX * tileSize;
+			const int maxX = std::min(minX + tileSize, width);
+			float farthest = 0.0f;
+
+			for (int y = bandMinY; y < bandMaxY; ++y) {
+				for (int x = minX; x < maxX; ++x) {
+					farthest = std::max(farthest, depth[y * pitch + x]);
+				}
+			}
+
+			tileDepth[tileY * tilesX + tileX] = farthest;
+		}
+	}
+
+	bool OcclusionBuffer::isVisible(const Bounds& bounds, const glm::mat4& modelMatrix) const {
+		const glm::mat4 modelViewProjection = viewProjection * modelMatrix;
+
+		// Find the screen space rectangle and nearest depth of the bounding box
+		glm::vec3 screenMin{0.0f};
+		glm::vec3 screenMax{0.0f};
+
+		for (int i = 0; i < 8; ++i) {
+			const glm::vec4 corner{
+				(i & 1) ? bounds.max.x : bounds.min.x,
+				(i & 2) ? bounds.max.y : bounds.min.y,
+				(i & 4) ? bounds.max.z : bounds.min.z,
+				1.0f
+			};
+
+			const glm::vec4 clip = modelViewProjection * corner;
+
+			// Anything crossing the near plane is treated as visible
+			if (clip.w <= clip.z * -1.0f) {
+				return true;
+			}
+
+			const glm::vec3 screen{
+				(clip.x / clip.w * 0.5f + 0.5f) * width,
+				(clip.y / clip.w * 0.5f + 0.5f) * height,
+				clip.z / clip.w * 0.5f + 0.5f,
+			};
+
+			if (i == 0) {
+				screenMin = screen;
+				screenMax = screen;
+			} else {
+				screenMin = glm::min(screenMin, screen);
+				screenMax = glm::max(screenMax, screen);
+			}
+		}
+
+		const int minX = std::max(static_cast<int>(std::floor(screenMin.x)), 0);
+		const int minY = std::max(static_cast<int>(std::floor(screenMin.y)), 0);
+		const int maxX = std::min(static_cast<int>(std::ceil(screenMax.x)), width - 1);
+		const int maxY = std::min(static_cast<int>(std::ceil(screenMax.y)), height - 1);
+
+		// Off screen bounds are left to frustum culling
+		if (minX > maxX || minY > maxY) {
+			return true;
+		}
+
+		const float nearest = screenMin.z;
+
+		for (int tileY = minY / tileSize; tileY <= maxY / tileSize; ++tileY) {
+			for (int tileX = minX / tileSize; tileX <= maxX / tileSize; ++tileX) {
+				// Skip tiles where every occluder is in front of the bounds
+				if (tileDepth[tileY * tilesX + tileX] < nearest) {
+					continue;
+				}
+
+				// Otherwise look for a pixel that is not covered
+				const int tileMinY = std::max(tileY * tileSize, minY);
+				const int tileMaxY = std::min(tileY * tileSize + tileSize - 1, maxY);
+				const int tileMinX = std::max(tileX * tileSize, minX);
+				const int tileMaxX = std::min(tileX * tileSize + tileSize - 1, maxX);
+
+				for (int y = tileMinY; y <= tileMaxY; ++y) {
+					for (int x = tileMinX; x <= tileMaxX; ++x) {
+						if (depth[y * pitch + x] >= nearest) {
+							return true;
+						}
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	int OcclusionBuffer::getWidth() const {
+		return width;
+	}
+
+	int OcclusionBuffer::getHeight() const {
+		return height;
+	}
+
+	const std::vector<float>& OcclusionBuffer::getDepth() const {
+		return depth;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+// STD
+#include <string>
+
+// Playground
+#include <Playground/Placement.hpp>
+
+std::ostream& operator<<(std::ostream& os, const Playground::Placement placement) {
+	std::string str;
+
+	switch (placement) {
+		case Playground::Placement::GRID:
+			str = "Playground::Placement::GRID";
+			break;
+		case Playground::Placement::RANDOM:
+			str = "Playground::Placement::RANDOM";
+			break;
+		case Playground::Placement::CLUSTERED:
+			str = "Playground::Placement::CLUSTERED";
+			break;
+		default:
+			str = "[TODO] Add ostream support for Playground::Placement::???? = "
+				+ std::to_string(static_cast<std::underlying_type_t<Playground::Placement>>(placement));
+			break;
+	}
+
+	os << str;
+	return os;
+}
\ No newline at end of file
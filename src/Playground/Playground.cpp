@@ -10,6 +10,7 @@
 
 // Playground
 #include <Playground/Playground.hpp>
+#include <Playground/GLState.hpp>
 
 namespace Playground {
 	void initializeOpenGL() {
@@ -69,7 +70,7 @@ namespace Playground {
 		glfwSwapInterval(1);
 
 		// Set resize callback
-		glfwSetWindowSizeCallback(window, [](GLFWwindow *window, int width, int height) { glViewport(0, 0, width, height); });
+		glfwSetWindowSizeCallback(window, [](GLFWwindow *window, int width, int height) { Playground::GLState::viewport(0, 0, width, height); });
 
 		// Initilize OpenGL
 		initializeOpenGL();
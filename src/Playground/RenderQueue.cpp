@@ -0,0 +1,75 @@
+// STD
+#include <cstring>
+
+// Playground
+#include <Playground/RenderQueue.hpp>
+
+namespace Playground {
+	uint64_t RenderQueue::makeKey(GLuint pass, GLuint program, GLuint material, GLuint vertexArray, float depth) {
+		const auto field = [](uint64_t value, unsigned int bits) {
+			return value & ((uint64_t{1} << bits) - 1);
+		};
+
+		// The bits of a positive float sort the same as its value, we drop the lowest mantissa bits that don't fit
+		uint32_t depthBitsValue;
+		std::memcpy(&depthBitsValue, &depth, sizeof(depth));
+		depthBitsValue >>= 32 - depthBits;
+
+		uint64_t key = field(pass, passBits);
+		key = (key << programBits) | field(program, programBits);
+		key = (key << materialBits) | field(material, materialBits);
+		key = (key << vertexArrayBits) | field(vertexArray, vertexArrayBits);
+		key = (key << depthBits) | field(depthBitsValue, depthBits);
+		return key;
+	}
+
+	GLuint RenderQueue::getPass(uint64_t key) {
+		return static_cast<GLuint>(key >> (64 - passBits));
+	}
+
+	void RenderQueue::clear() {
+		entries.clear();
+	}
+
+	void RenderQueue::push(uint64_t key, GLuint item) {
+		entries.push_back({key, item});
+	}
+
+	void RenderQueue::sort() {
+		const size_t count = entries.size();
+
+		if (count < 2) {
+			return;
+		}
+
+		scratch.resize(count);
+
+		// One stable counting sort per byte, starting with the least significant
+		for (unsigned int shift = 0; shift < 64; shift += 8) {
+			size_t offsets[257] = {};
+
+			for (const auto& entry : entries) {
+				++offsets[((entry.key >> shift) & 0xFF) + 1];
+			}
+
+			// Every key has the same byte, nothing would move
+			if (offsets[((entries.front().key >> shift) & 0xFF) + 1] == count) {
+				continue;
+			}
+
+			for (size_t i = 0; i < 256; ++i) {
+				offsets[i + 1] += offsets[i];
+			}
+
+			for (const auto& entry : entries) {
+				scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+			}
+
+			entries.swap(scratch);
+		}
+	}
+
+	const std::vector<RenderQueue::Entry>& RenderQueue::getEntries() const {
+		return entries;
+	}
+}
\ No newline at end of file
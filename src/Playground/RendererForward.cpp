@@ -1,33 +1,56 @@
 // STD
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 // GLM
 #include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
 
 // Playground
 #include <Playground/RendererForward.hpp>
 #include <Playground/Playground.hpp>
+#include <Playground/Frustum.hpp>
+#include <Playground/GLState.hpp>
 
 namespace Playground {
-	RendererForward::RendererForward(const int width, const int height, const AntiAliasingMode mode, const int power, int screenScale, const std::vector<Renderable>& objects, const std::vector<PointLight>& lights) :
-		objects{objects},
+	RendererForward::RendererForward(const int width, const int height, const AntiAliasingMode mode, const int power, int screenScale, const SubmissionMode submission, AssetManager& assets, ThreadPool& pool, const Scene& scene, const std::vector<PointLight>& lights) :
+		arena{assets.getArena()},
+		materials{assets.getMaterials()},
+		scene{scene},
 		lights{lights},
 		lightCount{static_cast<GLuint>(lights.size())},
 		fboWidth{width},
 		fboHeight{height},
 		screenWidth{width},
 		screenHeight{height},
-		scale{screenScale} {
+		scale{screenScale},
+		sampleCount{1},
+		fboMultisample{0},
+		fboMultisampleColor{0},
+		fboMultisampleDepth{0},
+		passPrograms{},
+		submission{submission},
+		stats{},
+		builtNodeCount{0},
+		builtReadyCount{0},
+		batchCommandCount{0},
+		opaqueBatchCount{0},
+		depthPyramidValid{false},
+		cullCountBuffers{},
+		cullCountFences{},
+		cullCounts{},
+		cullCountIndex{0},
+		programsReady{false},
+		occlusionBuffer{256, std::max(256 * height / width, 1), pool} {
 
 		if (lightCount > MAX_LIGHTS) {
 			std::cout << "[WARNING] The size of \"lights\" must not exceed Playground::MAX_LIGHTS = " << MAX_LIGHTS << ". Clamping.\n";
 			lightCount = Playground::MAX_LIGHTS;
 		}
 
-		// Load unit plane
-		unitPlane = std::make_shared<Model>("models/unit_plane.obj", 2.0f);
+		// Load unit plane, we need it before we can draw anything
+		unitPlane = assets.getModel("models/unit_plane.obj", 2.0f);
+		assets.wait(unitPlane);
 
 		glm::ivec2 maxViewportSize;
 
@@ -63,152 +86,151 @@ namespace Playground {
 		}
 
 		if (mode == AntiAliasingMode::NONE) {
+		} else if (mode == AntiAliasingMode::MSAA) {
+			// The power is the number of samples per pixel
+			GLint maxSamples;
+			glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+			sampleCount = std::min(std::max(power, 2), maxSamples);
+
+			if (sampleCount != power) {
+				std::cout << "[WARNING] " << power << " samples are not supported for MSAA. Using " << sampleCount << " samples.\n";
+			}
 		} else {
 			std::cout << "[WARNING] Anit aliasing mode \"" << mode << "\" is not supported yet for RendererForward. Not using anti-aliasing\n";
 		}
 		
 		{ // Setup fbo
 			// Create the color texture for the frame buffer
-			glGenTextures(1, &fboColorTexture);
-			glBindTexture(GL_TEXTURE_2D, fboColorTexture);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8, fboWidth, fboHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+			glCreateTextures(GL_TEXTURE_2D, 1, &fboColorTexture);
+			glTextureStorage2D(fboColorTexture, 1, GL_SRGB8, fboWidth, fboHeight);
 
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(fboColorTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTextureParameteri(fboColorTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTextureParameteri(fboColorTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(fboColorTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 			// Create the depth texture for the frame buffer
-			glGenTextures(1, &fboDepthTexture);
-			glBindTexture(GL_TEXTURE_2D, fboDepthTexture);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32, fboWidth, fboHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+			glCreateTextures(GL_TEXTURE_2D, 1, &fboDepthTexture);
+			glTextureStorage2D(fboDepthTexture, 1, GL_DEPTH_COMPONENT32, fboWidth, fboHeight);
 
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(fboDepthTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTextureParameteri(fboDepthTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTextureParameteri(fboDepthTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(fboDepthTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 			// Create frame buffer
 			glCreateFramebuffers(1, &fbo);
 
-			// Bind textures to frameBuffer
-			glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fboColorTexture, 0);
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, fboDepthTexture, 0);
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			// Attach textures to frameBuffer
+			glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, fboColorTexture, 0);
+			glNamedFramebufferTexture(fbo, GL_DEPTH_ATTACHMENT, fboDepthTexture, 0);
 		}
 
-		{ // Setup fboScreen
-			// Create the color texture for the frame buffer
-			glGenTextures(1, &fboScreenColorTexture);
-			glBindTexture(GL_TEXTURE_2D, fboScreenColorTexture);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8, screenWidth, screenHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		if (sampleCount > 1) { // Setup fboMultisample
+			// Use the same formats as fbo so the color samples can be resolved with a blit
+			glCreateRenderbuffers(1, &fboMultisampleColor);
+			glNamedRenderbufferStorageMultisample(fboMultisampleColor, sampleCount, GL_SRGB8, fboWidth, fboHeight);
 
-			// Create frame buffer
-			glCreateFramebuffers(1, &fboScreen);
+			// The depth samples are read by depthResolveProgram
+			glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &fboMultisampleDepth);
+			glTextureStorage2DMultisample(fboMultisampleDepth, sampleCount, GL_DEPTH_COMPONENT32, fboWidth, fboHeight, GL_TRUE);
 
-			// Bind textures to frameBuffer
-			glBindFramebuffer(GL_FRAMEBUFFER, fboScreen);
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fboScreenColorTexture, 0);
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glCreateFramebuffers(1, &fboMultisample);
+			glNamedFramebufferRenderbuffer(fboMultisample, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, fboMultisampleColor);
+			glNamedFramebufferTexture(fboMultisample, GL_DEPTH_ATTACHMENT, fboMultisampleDepth, 0);
 		}
 
-		// Setup the model program
-		modelProgram = glCreateProgram();
-		{
-			GLuint vertShader = glCreateShader(GL_VERTEX_SHADER);
-			GLuint fragShader = glCreateShader(GL_FRAGMENT_SHADER);
-
-			const std::string vertShaderSource = loadFile("shaders/forward/vert.glsl");
-			const std::string fragShaderSource = loadFile("shaders/forward/frag.glsl");
+		{ // Setup fboTransparent
+			// Weighted color sums need range and precision, revealage is a product of transmittances
+			glCreateTextures(GL_TEXTURE_2D, 1, &fboAccumulationTexture);
+			glTextureStorage2D(fboAccumulationTexture, 1, GL_RGBA16F, fboWidth, fboHeight);
 
-			const GLchar* vertShaderSourcePtr = vertShaderSource.c_str();
-			const GLchar* fragShaderSourcePtr = fragShaderSource.c_str();
+			glCreateTextures(GL_TEXTURE_2D, 1, &fboRevealageTexture);
+			glTextureStorage2D(fboRevealageTexture, 1, GL_R16F, fboWidth, fboHeight);
 
-			glShaderSource(vertShader, 1, &vertShaderSourcePtr, nullptr);
-			glShaderSource(fragShader, 1, &fragShaderSourcePtr, nullptr);
-
-			glCompileShader(vertShader);
-			glCompileShader(fragShader);
-
-			checkShaderSuccess(vertShader);
-			checkShaderSuccess(fragShader);
-
-			// Setup program
-			glAttachShader(modelProgram, vertShader);
-			glAttachShader(modelProgram, fragShader);
-
-			glLinkProgram(modelProgram);
-			
-			checkLinkStatus(modelProgram);
-
-			// Detach and delete shaders
-			glDetachShader(modelProgram, vertShader);
-			glDetachShader(modelProgram, fragShader);
-
-			glDeleteShader(vertShader);
-			glDeleteShader(fragShader);
+			for (const auto texture : {fboAccumulationTexture, fboRevealageTexture}) {
+				glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+				glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			}
 
-			glBindFragDataLocation(modelProgram, 0, "finalColor");
+			// Transparent surfaces are tested against the opaque depth without writing it
+			const GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+			glCreateFramebuffers(1, &fboTransparent);
+			glNamedFramebufferTexture(fboTransparent, GL_COLOR_ATTACHMENT0, fboAccumulationTexture, 0);
+			glNamedFramebufferTexture(fboTransparent, GL_COLOR_ATTACHMENT1, fboRevealageTexture, 0);
+			glNamedFramebufferTexture(fboTransparent, GL_DEPTH_ATTACHMENT, fboDepthTexture, 0);
+			glNamedFramebufferDrawBuffers(fboTransparent, 2, drawBuffers);
 		}
 
-		// Setup the screen program
-		screenProgram = glCreateProgram();
-		{
-			GLuint vertShader = glCreateShader(GL_VERTEX_SHADER);
-			GLuint fragShader = glCreateShader(GL_FRAGMENT_SHADER);
-
-			const std::string vertShaderSource = loadFile("shaders/forward/super_sample_vert.glsl");
-			const std::string fragShaderSource = loadFile("shaders/forward/super_sample_frag.glsl");
-
-			const GLchar* vertShaderSourcePtr = vertShaderSource.c_str();
-			const GLchar* fragShaderSourcePtr = fragShaderSource.c_str();
+		{ // Setup fboScreen
+			// Create the color texture for the frame buffer
+			glCreateTextures(GL_TEXTURE_2D, 1, &fboScreenColorTexture);
+			glTextureStorage2D(fboScreenColorTexture, 1, GL_SRGB8, screenWidth, screenHeight);
 
-			glShaderSource(vertShader, 1, &vertShaderSourcePtr, nullptr);
-			glShaderSource(fragShader, 1, &fragShaderSourcePtr, nullptr);
+			glTextureParameteri(fboScreenColorTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTextureParameteri(fboScreenColorTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTextureParameteri(fboScreenColorTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(fboScreenColorTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-			glCompileShader(vertShader);
-			glCompileShader(fragShader);
+			// Create frame buffer
+			glCreateFramebuffers(1, &fboScreen);
 
-			checkShaderSuccess(vertShader);
-			checkShaderSuccess(fragShader);
+			// Attach textures to frameBuffer
+			glNamedFramebufferTexture(fboScreen, GL_COLOR_ATTACHMENT0, fboScreenColorTexture, 0);
+		}
 
-			// Setup program
-			glAttachShader(screenProgram, vertShader);
-			glAttachShader(screenProgram, fragShader);
+		// Setup the depth pyramid used for occlusion culling
+		if (submission == SubmissionMode::GPU) {
+			depthPyramid = std::make_unique<DepthPyramid>(fboWidth, fboHeight);
+		}
 
-			glLinkProgram(screenProgram);
+		// Setup our programs, the vertex shaders declare the attribute locations of the geometry arena so any of them can draw from its VAO.
+		// Every program is submitted before any is polled so the driver can compile them at the same time.
+		// The model program has a variant per pass, built when the pass is first drawn
+		modelPrograms = std::make_unique<ShaderVariants>(std::vector<ShaderProgram::Stage>{
+			{GL_VERTEX_SHADER, "shaders/forward/vert.glsl"},
+			{GL_FRAGMENT_SHADER, "shaders/forward/frag.glsl"},
+		});
+
+		// The scale never changes so the sample loops can be unrolled
+		screenProgram = std::make_unique<ShaderProgram>(std::vector<ShaderProgram::Stage>{
+			{GL_VERTEX_SHADER, "shaders/forward/super_sample_vert.glsl"},
+			{GL_FRAGMENT_SHADER, "shaders/forward/super_sample_frag.glsl"},
+		}, std::vector<ShaderProgram::Define>{
+			{"SCALE", std::to_string(scale)},
+		});
+
+		compositeProgram = std::make_unique<ShaderProgram>(std::vector<ShaderProgram::Stage>{
+			{GL_VERTEX_SHADER, "shaders/forward/super_sample_vert.glsl"},
+			{GL_FRAGMENT_SHADER, "shaders/forward/composite_frag.glsl"},
+		});
+
+		if (sampleCount > 1) {
+			depthResolveProgram = std::make_unique<ShaderProgram>(std::vector<ShaderProgram::Stage>{
+				{GL_VERTEX_SHADER, "shaders/forward/super_sample_vert.glsl"},
+				{GL_FRAGMENT_SHADER, "shaders/forward/depth_resolve_frag.glsl"},
+			}, std::vector<ShaderProgram::Define>{
+				{"SAMPLE_COUNT", std::to_string(sampleCount)},
+			});
+		}
 
-			checkLinkStatus(screenProgram);
+		cullProgram = std::make_unique<ShaderProgram>(std::vector<ShaderProgram::Stage>{
+			{GL_COMPUTE_SHADER, "shaders/forward/cull_comp.glsl"},
+		});
 
-			// Detach and delete shaders
-			glDetachShader(screenProgram, vertShader);
-			glDetachShader(screenProgram, fragShader);
+		meshletProgram = std::make_unique<ShaderProgram>(std::vector<ShaderProgram::Stage>{
+			{GL_COMPUTE_SHADER, "shaders/forward/meshlet_cull_comp.glsl"},
+		});
 
-			glDeleteShader(vertShader);
-			glDeleteShader(fragShader);
-			
-			glBindFragDataLocation(screenProgram, 0, "finalColor");
-		}
+		// Start the opaque variant now since every frame needs it, the uniforms are looked up once everything is ready
+		getModelProgram(RenderQueue::opaquePass);
 
-		// Get locations
-		mvpLocation = glGetUniformLocation(modelProgram, "mvp");
-		modelMatrixLocation = glGetUniformLocation(modelProgram, "modelMatrix");
-		viewPositionLocation = glGetUniformLocation(modelProgram, "viewPosition");
-		lightCountLocation = glGetUniformLocation(modelProgram, "lightCount");
-		colorAttachmentLocation = glGetUniformLocation(screenProgram, "colorAttachment");
-		scaleLocation = glGetUniformLocation(screenProgram, "scale");
-		
 		// Setup lights UBO
 		GLsizeiptr pointLightSize = sizeof(PointLight) + sizeof(GLfloat); // We need to add the extra sizeof(Glfloat) here for padding
-		glGenBuffers(1, &ubo);
-		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-		glBufferData(GL_UNIFORM_BUFFER, pointLightSize * lightCount, nullptr, GL_STATIC_DRAW);
+		glCreateBuffers(1, &ubo);
+		glNamedBufferData(ubo, pointLightSize * lightCount, nullptr, GL_STATIC_DRAW);
 
 		// Set UBO data
 		{
@@ -229,94 +251,840 @@ namespace Playground {
 				tempData[7] = lights[i].intensity;
 
 				// Set the data
-				glBufferSubData(GL_UNIFORM_BUFFER, i * pointLightSize, pointLightSize, tempData);
+				glNamedBufferSubData(ubo, i * pointLightSize, pointLightSize, tempData);
 			}
 		}
-		
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-		// Bind our UBO to binding point 0
+		// Bind our UBO to binding point 0, where every variant of the model program declares "Lights"
 		glBindBufferBase(GL_UNIFORM_BUFFER, 0, ubo);
 
-		// Bind "Lights" (which is at index lightsIndex) from modelProgram to binding point 0
-		GLuint lightsIndex = glGetUniformBlockIndex(modelProgram, "Lights");
-		glUniformBlockBinding(modelProgram, lightsIndex, 0);
-		
-		// Setup the models
-		for (auto& obj : objects) {
-			obj.model->setupForUseWith(modelProgram);
+		// Setup the per object and per instance data buffers
+		glCreateBuffers(1, &objectBuffer);
+		glNamedBufferData(objectBuffer, sizeof(ObjectData), nullptr, GL_STREAM_DRAW);
+
+		glCreateBuffers(1, &instanceBuffer);
+		glNamedBufferData(instanceBuffer, sizeof(GLuint), nullptr, GL_STREAM_DRAW);
+		arena.setInstanceBuffer(instanceBuffer);
+
+		// Setup the indirect draw buffers
+		glCreateBuffers(1, &commandBuffer);
+		glNamedBufferData(commandBuffer, sizeof(DrawCommand), nullptr, GL_DYNAMIC_COPY);
+
+		glCreateBuffers(1, &commandTemplateBuffer);
+		glNamedBufferData(commandTemplateBuffer, sizeof(DrawCommand), nullptr, GL_STATIC_DRAW);
+
+		glCreateBuffers(1, &lodErrorBuffer);
+		glNamedBufferData(lodErrorBuffer, sizeof(GLfloat), nullptr, GL_STATIC_DRAW);
+
+		// Setup the meshlet buffers
+		glCreateBuffers(1, &meshletBuffer);
+		glNamedBufferData(meshletBuffer, sizeof(Meshlet), nullptr, GL_STATIC_DRAW);
+
+		glCreateBuffers(1, &meshletVertexBuffer);
+		glNamedBufferData(meshletVertexBuffer, sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+
+		glCreateBuffers(1, &meshletTriangleBuffer);
+		glNamedBufferData(meshletTriangleBuffer, sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+
+		glCreateBuffers(1, &meshletWorkBuffer);
+		glNamedBufferData(meshletWorkBuffer, sizeof(MeshletWork), nullptr, GL_STATIC_DRAW);
+
+		glCreateBuffers(1, &meshletIndexBuffer);
+		glNamedBufferData(meshletIndexBuffer, sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+
+		// Setup the cull count buffers
+		glCreateBuffers(2, cullCountBuffers);
+
+		for (const auto buffer : cullCountBuffers) {
+			glNamedBufferData(buffer, sizeof(cullCounts), nullptr, GL_DYNAMIC_READ);
 		}
 
-		unitPlane->setupForUseWith(screenProgram);
+		// Setup the per frame data of CPU submission
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+
+		if (submission == SubmissionMode::CPU) {
+			frameRing = std::make_unique<FrameRing>(1 << 16);
+		}
 	};
 
 	RendererForward::~RendererForward() {
 		glDeleteFramebuffers(1, &fbo);
 		glDeleteTextures(1, &fboColorTexture);
 		glDeleteTextures(1, &fboDepthTexture);
-		glDeleteProgram(modelProgram);
-		glDeleteProgram(screenProgram);
+		glDeleteFramebuffers(1, &fboScreen);
+		glDeleteTextures(1, &fboScreenColorTexture);
+		glDeleteFramebuffers(1, &fboMultisample);
+		glDeleteRenderbuffers(1, &fboMultisampleColor);
+		glDeleteTextures(1, &fboMultisampleDepth);
+		glDeleteFramebuffers(1, &fboTransparent);
+		glDeleteTextures(1, &fboAccumulationTexture);
+		glDeleteTextures(1, &fboRevealageTexture);
 		glDeleteBuffers(1, &ubo);
+		glDeleteBuffers(1, &objectBuffer);
+		glDeleteBuffers(1, &instanceBuffer);
+		glDeleteBuffers(1, &commandBuffer);
+		glDeleteBuffers(1, &commandTemplateBuffer);
+		glDeleteBuffers(1, &lodErrorBuffer);
+		glDeleteBuffers(1, &meshletBuffer);
+		glDeleteBuffers(1, &meshletVertexBuffer);
+		glDeleteBuffers(1, &meshletTriangleBuffer);
+		glDeleteBuffers(1, &meshletWorkBuffer);
+		glDeleteBuffers(1, &meshletIndexBuffer);
+		glDeleteBuffers(2, cullCountBuffers);
+
+		for (const auto fence : cullCountFences) {
+			if (fence != nullptr) {
+				glDeleteSync(fence);
+			}
+		}
+
+		GLState::invalidate();
 	};
 
 	void RendererForward::draw(const Camera& camera) {
+		GLState::resetStats();
+
+		// Show nothing until our programs are compiled rather than stalling the frame on the driver
+		if (!pollPrograms()) {
+			stats = {};
+			GLState::bindFramebuffer(fboScreen);
+			glClear(GL_COLOR_BUFFER_BIT);
+			GLState::bindFramebuffer(0);
+			return;
+		}
+
 		// Bind our frame buffer
-		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-		glViewport(0, 0, fboWidth, fboHeight);
+		GLState::bindFramebuffer(sampleCount > 1 ? fboMultisample : fbo);
+		GLState::viewport(0, 0, fboWidth, fboHeight);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		// Get camera matrices
 		const auto projection = camera.getProjectionMatrix();
-		const auto view = camera.getViewMatrix();
+		const auto viewProjection = projection * camera.getViewMatrix();
 
-		// Use the model program
-		glUseProgram(modelProgram);
+		// Converts a model space error at a distance of one unit into a multiple of our screen space error threshold
+		const float lodScale = 0.5f * screenHeight * projection[1][1] / lodErrorThreshold;
 
-		// Update uniforms
-		glUniform3fv(viewPositionLocation, 1, &camera.getPosition()[0]);
-		glUniform1uiv(lightCountLocation, 1, &lightCount);
+		// Reset our stats
+		stats = {};
+		stats.objectCount = scene.getNodeCount();
 
-		// Draw the models
-		for (const auto& obj : objects) {
-			// Update matrices
-			glm::mat4 modelMatrix = glm::translate({}, obj.position);
-			const auto mvp = projection * view * modelMatrix;
+		// Only rebuild our items and batches when our objects change or finish loading, otherwise only update what moved
+		const bool rebuild = builtNodeCount != scene.getNodeCount() || builtReadyCount != countReadyObjects();
 
-			// Update the uniforms
-			glUniformMatrix4fv(modelMatrixLocation, 1, GL_FALSE, &modelMatrix[0][0]);
-			glUniformMatrix4fv(mvpLocation, 1, GL_FALSE, &mvp[0][0]);
+		if (submission == SubmissionMode::GPU) {
+			if (rebuild) {
+				buildCommands();
+			} else {
+				updateTransforms();
+			}
+
+			cullObjectsGPU(viewProjection, camera.getPosition(), lodScale);
+		} else {
+			// Group our submeshes into batches, cull them, pick their level of detail and upload the per item and per instance data
+			if (rebuild) {
+				buildObjects();
+			} else {
+				updateTransforms();
+			}
 
-			// Draw the model
-			glBindVertexArray(obj.model->getVAO());
-			glDrawArrays(GL_TRIANGLES, 0, obj.model->getCount());
+			cullObjectsCPU(viewProjection);
+			occlusionCullObjectsCPU(viewProjection);
+			selectLodsCPU(camera.getPosition(), lodScale);
+			buildInstances();
+			buildQueue();
+			uploadFrameData();
+		}
+
+		stats.submeshCount = static_cast<unsigned int>(items.size());
+
+		useModelProgram(RenderQueue::opaquePass, viewProjection, camera.getPosition());
+
+		if (sampleCount > 1) {
+			GLState::setEnabled(GL_SAMPLE_ALPHA_TO_COVERAGE, true);
+		}
+
+		// All models share the vertex format and buffers of the arena and the materials of the library
+		GLState::bindVertexArray(arena.getVAO());
+		materials.bind(1, 1);
+
+		if (submission == SubmissionMode::GPU) {
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectBuffer);
+
+			// Draw every opaque batch with the instance counts written by the cull shader
+			GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(opaqueBatchCount), 0);
+			++stats.drawCount;
+
+			// Draw the visible meshlets from the indices compacted by the meshlet cull shader
+			if (commands.size() > batchCommandCount) {
+				arena.setElementBuffer(meshletIndexBuffer);
+				glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<GLvoid*>(batchCommandCount * sizeof(DrawCommand)),
+					static_cast<GLsizei>(commands.size() - batchCommandCount), 0);
+				arena.setElementBuffer(0);
+				++stats.drawCount;
+			}
+
+			GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		} else {
+			drawQueue(RenderQueue::opaquePass);
+		}
+
+		// Resolve the samples into fbo
+		if (sampleCount > 1) {
+			GLState::setEnabled(GL_SAMPLE_ALPHA_TO_COVERAGE, false);
+			glBlitNamedFramebuffer(fboMultisample, fbo, 0, 0, fboWidth, fboHeight, 0, 0, fboWidth, fboHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+			// A depth blit may pick any one sample, which would let the depth pyramid cull objects visible in the rest of the pixel.
+			// Resolve to the farthest sample instead so occlusion culling stays conservative.
+			GLState::bindFramebuffer(fbo);
+			GLState::useProgram(depthResolveProgram->getProgram());
+			GLState::bindTextureUnit(0, fboMultisampleDepth);
+			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			glDepthFunc(GL_ALWAYS);
+
+			const auto& planeMesh = unitPlane->getMesh();
+			glDrawElementsBaseVertex(GL_TRIANGLES, planeMesh.count, GL_UNSIGNED_INT, reinterpret_cast<GLvoid*>(planeMesh.firstIndex * sizeof(GLuint)), planeMesh.baseVertex);
+
+			glDepthFunc(GL_LESS);
+			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		}
+
+		if (submission == SubmissionMode::GPU) {
+			// Build the depth pyramid we will cull against next frame
+			depthPyramid->build(fboDepthTexture);
+			previousViewProjection = viewProjection;
+			depthPyramidValid = true;
+		}
+
+		drawTransparent(viewProjection, camera.getPosition());
+
+		if (submission == SubmissionMode::CPU) {
+			// Fence the region we drew from so we don't overwrite it until the GPU is done with it
+			frameRing->endFrame();
 		}
 
 
 		// Bind our screen frame buffer
-		glBindFramebuffer(GL_FRAMEBUFFER, fboScreen);
-		glViewport(0, 0, screenWidth, screenHeight);
+		GLState::bindFramebuffer(fboScreen);
+		GLState::viewport(0, 0, screenWidth, screenHeight);
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		// Use the screen program
-		glUseProgram(screenProgram);
+		GLState::useProgram(screenProgram->getProgram());
 
 		// Activate our textures
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, fboColorTexture);
+		GLState::bindTextureUnit(0, fboColorTexture);
 
 		// Update uniforms
 		glUniform1i(colorAttachmentLocation, 0);
-		glUniform1iv(scaleLocation, 1, &scale);
 
 		// Downsample and draw to screen
-		glBindVertexArray(unitPlane->getVAO());
-		glDrawArrays(GL_TRIANGLES, 0, unitPlane->getCount());
+		const auto& planeMesh = unitPlane->getMesh();
+		glDrawElementsBaseVertex(GL_TRIANGLES, planeMesh.count, GL_UNSIGNED_INT, reinterpret_cast<GLvoid*>(planeMesh.firstIndex * sizeof(GLuint)), planeMesh.baseVertex);
 
 		// Unbind our frame buffer
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLState::bindFramebuffer(0);
+
+		const auto& stateStats = GLState::getStats();
+		stats.stateCallCount = stateStats.callCount;
+		stats.redundantStateCount = stateStats.redundantCount;
 	};
 
 	int RendererForward::getFrameBuffer() const {
 		return fboScreen;
 	};
+
+	const FrameStats& RendererForward::getFrameStats() const {
+		return stats;
+	};
+
+	bool RendererForward::pollPrograms() {
+		if (programsReady) {
+			return true;
+		}
+
+		// Every program is polled each time so the ones that are done get finished while we wait on the rest
+		bool ready = getModelProgram(RenderQueue::opaquePass).isReady();
+		ready = screenProgram->isReady() && ready;
+		ready = compositeProgram->isReady() && ready;
+		ready = (!depthResolveProgram || depthResolveProgram->isReady()) && ready;
+		ready = cullProgram->isReady() && ready;
+		ready = meshletProgram->isReady() && ready;
+		ready = (!depthPyramid || depthPyramid->isReady()) && ready;
+
+		if (!ready) {
+			return false;
+		}
+
+		// Get locations
+		colorAttachmentLocation = screenProgram->getUniformLocation("colorAttachment");
+		frustumPlanesLocation = cullProgram->getUniformLocation("frustumPlanes");
+		objectCountLocation = cullProgram->getUniformLocation("objectCount");
+		occlusionCullingLocation = cullProgram->getUniformLocation("occlusionCulling");
+		previousViewProjectionLocation = cullProgram->getUniformLocation("previousViewProjection");
+		cullViewPositionLocation = cullProgram->getUniformLocation("viewPosition");
+		lodScaleLocation = cullProgram->getUniformLocation("lodScale");
+		meshletFrustumPlanesLocation = meshletProgram->getUniformLocation("frustumPlanes");
+		meshletWorkCountLocation = meshletProgram->getUniformLocation("workCount");
+		meshletOcclusionCullingLocation = meshletProgram->getUniformLocation("occlusionCulling");
+		meshletPreviousViewProjectionLocation = meshletProgram->getUniformLocation("previousViewProjection");
+		meshletViewPositionLocation = meshletProgram->getUniformLocation("viewPosition");
+
+		programsReady = true;
+		return true;
+	};
+
+	size_t RendererForward::countReadyObjects() const {
+		size_t count = 0;
+
+		for (GLuint node = 0; node < scene.getNodeCount(); ++node) {
+			const auto& model = scene.getModel(node);
+			count += model && model->isReady();
+		}
+
+		return count;
+	};
+
+	bool RendererForward::usesMeshlets(const Submesh& submesh) const {
+		// Transparent submeshes are always batched so their draws can be split off into the transparent pass
+		return submission == SubmissionMode::GPU && submesh.meshlets.size() >= minMeshletCount && !materials.isTransparent(submesh.materialId);
+	};
+
+	void RendererForward::buildObjects() {
+		// Split our objects into their submeshes, skipping those that are still loading
+		items.clear();
+		nodeItems.resize(scene.getNodeCount() + 1);
+		builtNodeCount = scene.getNodeCount();
+		builtReadyCount = 0;
+
+		for (GLuint node = 0; node < scene.getNodeCount(); ++node) {
+			const auto& model = scene.getModel(node);
+			nodeItems[node] = static_cast<GLuint>(items.size());
+
+			if (!model || !model->isReady()) {
+				continue;
+			}
+
+			++builtReadyCount;
+
+			for (const auto& submesh : model->getSubmeshes()) {
+				items.push_back({node, &submesh});
+			}
+		}
+
+		nodeItems.back() = static_cast<GLuint>(items.size());
+
+		batches.clear();
+		batchLookup.clear();
+		objectData.resize(items.size());
+
+		// Write the per item data and count the number of instances of each submesh.
+		// Each submesh gets one batch per level of detail, each with room for every instance of the submesh.
+		// Opaque items go first so each pass draws a contiguous range of batches.
+		for (const bool transparent : {false, true}) {
+			for (size_t i = 0; i < items.size(); ++i) {
+				const auto& submesh = *items[i].submesh;
+
+				if (materials.isTransparent(submesh.materialId) != transparent) {
+					continue;
+				}
+
+				objectData[i].modelMatrix = scene.getWorldMatrix(items[i].object);
+				objectData[i].boundingSphere = {submesh.bounds.center, submesh.bounds.radius};
+				objectData[i].material = submesh.materialId;
+
+				if (usesMeshlets(submesh)) {
+					objectData[i].batch = noBatch;
+					objectData[i].lodCount = 0;
+					continue;
+				}
+
+				const auto lodCount = submesh.lods.size();
+				const auto inserted = batchLookup.emplace(&submesh, batches.size());
+
+				if (inserted.second) {
+					for (size_t lod = 0; lod < lodCount; ++lod) {
+						batches.push_back({&submesh, static_cast<GLuint>(lod), 0, 0});
+					}
+				}
+
+				for (size_t lod = 0; lod < lodCount; ++lod) {
+					++batches[inserted.first->second + lod].instanceCount;
+				}
+
+				objectData[i].batch = static_cast<GLuint>(inserted.first->second);
+				objectData[i].lodCount = static_cast<GLuint>(lodCount);
+			}
+
+			if (!transparent) {
+				opaqueBatchCount = batches.size();
+			}
+		}
+
+		// Give each batch a contiguous range of instances
+		GLuint offset = 0;
+
+		for (auto& batch : batches) {
+			batch.firstInstance = offset;
+			offset += batch.instanceCount;
+		}
+	};
+
+	void RendererForward::buildInstances() {
+		// Count the visible instances of each batch
+		for (auto& batch : batches) {
+			batch.instanceCount = 0;
+		}
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			batches[objectData[i].batch + objectLod[i]].instanceCount += objectVisible[i];
+		}
+
+		// Give each batch a contiguous range of instances
+		GLuint offset = 0;
+		batchCursors.resize(batches.size());
+
+		for (size_t i = 0; i < batches.size(); ++i) {
+			batches[i].firstInstance = offset;
+			batchCursors[i] = offset;
+			offset += batches[i].instanceCount;
+		}
+
+		// Place each visible item in its batch's range
+		instanceData.resize(offset);
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (objectVisible[i]) {
+				instanceData[batchCursors[objectData[i].batch + objectLod[i]]++] = static_cast<GLuint>(i);
+			}
+		}
+	};
+
+	void RendererForward::buildQueue() {
+		// Sort each batch by the closest of its visible instances
+		batchDistances.assign(batches.size(), std::numeric_limits<float>::max());
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (objectVisible[i]) {
+				float& distance = batchDistances[objectData[i].batch + objectLod[i]];
+				distance = std::min(distance, objectDistance[i]);
+			}
+		}
+
+		renderQueue.clear();
+
+		// Each pass draws with its own variant of the model program and every model draws from the arena's vertex array,
+		// so the pass is also the program index and the vertex array index is always zero
+
+		for (size_t i = 0; i < batches.size(); ++i) {
+			if (batches[i].instanceCount == 0) {
+				continue;
+			}
+
+			const GLuint material = batches[i].submesh->materialId;
+			const bool transparent = i >= opaqueBatchCount;
+			const GLuint pass = transparent ? RenderQueue::transparentPass : RenderQueue::opaquePass;
+			renderQueue.push(RenderQueue::makeKey(pass, pass, material, 0, batchDistances[i]), static_cast<GLuint>(i));
+		}
+
+		renderQueue.sort();
+	};
+
+	ShaderProgram& RendererForward::getModelProgram(GLuint pass) {
+		auto& passProgram = passPrograms[pass];
+
+		// A ready program never changes, until then we keep asking so a variant that fails to link falls back
+		if (passProgram.program != nullptr) {
+			return *passProgram.program;
+		}
+
+		const bool transparent = pass == RenderQueue::transparentPass;
+
+		// Alpha tested materials turn their mask into sample coverage when we have samples, otherwise they discard.
+		// Masks always discard in the transparent pass, there are no samples to cover.
+		auto& program = modelPrograms->get({
+			{"LIGHT_COUNT", std::to_string(lightCount) + "u"},
+			{"ALPHA_TO_COVERAGE", !transparent && sampleCount > 1 ? "true" : "false"},
+			{"TRANSPARENT_PASS", transparent ? "true" : "false"},
+		});
+
+		if (program.isReady()) {
+			passProgram.program = &program;
+			passProgram.viewProjectionLocation = program.getUniformLocation("viewProjection");
+			passProgram.viewPositionLocation = program.getUniformLocation("viewPosition");
+			passProgram.lightCountLocation = program.getUniformLocation("lightCount");
+			passProgram.alphaToCoverageLocation = program.getUniformLocation("alphaToCoverage");
+			passProgram.transparentPassLocation = program.getUniformLocation("transparentPass");
+		}
+
+		return program;
+	};
+
+	void RendererForward::useModelProgram(GLuint pass, const glm::mat4& viewProjection, const glm::vec3& viewPosition) {
+		// Only called once the pass's program is ready, which fills in its locations
+		GLState::useProgram(getModelProgram(pass).getProgram());
+		const auto& passProgram = passPrograms[pass];
+
+		// Specialized variants don't have the last three, setting location -1 does nothing
+		glUniformMatrix4fv(passProgram.viewProjectionLocation, 1, GL_FALSE, &viewProjection[0][0]);
+		glUniform3fv(passProgram.viewPositionLocation, 1, &viewPosition[0]);
+		glUniform1ui(passProgram.lightCountLocation, lightCount);
+		glUniform1i(passProgram.alphaToCoverageLocation, pass == RenderQueue::opaquePass && sampleCount > 1);
+		glUniform1i(passProgram.transparentPassLocation, pass == RenderQueue::transparentPass);
+	};
+
+	void RendererForward::drawQueue(GLuint pass) {
+		// Draw the models in queue order, one instanced draw per batch with visible objects
+		for (const auto& entry : renderQueue.getEntries()) {
+			if (RenderQueue::getPass(entry.key) != pass) {
+				continue;
+			}
+
+			const auto& batch = batches[entry.item];
+			const auto& mesh = batch.submesh->lods[batch.lod].mesh;
+			glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, mesh.count, GL_UNSIGNED_INT,
+				reinterpret_cast<GLvoid*>(mesh.firstIndex * sizeof(GLuint)), batch.instanceCount, mesh.baseVertex, batch.firstInstance);
+			++stats.drawCount;
+		}
+	};
+
+	void RendererForward::drawTransparent(const glm::mat4& viewProjection, const glm::vec3& viewPosition) {
+		// The queue is sorted by pass so any transparent entries are at the end
+		const auto& entries = renderQueue.getEntries();
+		const bool hasTransparent = submission == SubmissionMode::GPU ? opaqueBatchCount < batchCommandCount
+			: !entries.empty() && RenderQueue::getPass(entries.back().key) == RenderQueue::transparentPass;
+
+		// Transparent surfaces pop in once their variant is compiled instead of stalling the frame on it
+		if (!hasTransparent || !getModelProgram(RenderQueue::transparentPass).isReady()) {
+			return;
+		}
+
+		// Sum the weighted colors and multiply the transmittance of every transparent surface, both are independent of draw order
+		const GLfloat clearAccumulation[] = {0.0f, 0.0f, 0.0f, 0.0f};
+		const GLfloat clearRevealage[] = {1.0f, 0.0f, 0.0f, 0.0f};
+		GLState::bindFramebuffer(fboTransparent);
+		glClearBufferfv(GL_COLOR, 0, clearAccumulation);
+		glClearBufferfv(GL_COLOR, 1, clearRevealage);
+
+		GLState::depthMask(GL_FALSE);
+		GLState::setEnabled(GL_BLEND, true);
+		glBlendFunci(0, GL_ONE, GL_ONE);
+		glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+
+		useModelProgram(RenderQueue::transparentPass, viewProjection, viewPosition);
+
+		if (submission == SubmissionMode::GPU) {
+			GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<GLvoid*>(opaqueBatchCount * sizeof(DrawCommand)),
+				static_cast<GLsizei>(batchCommandCount - opaqueBatchCount), 0);
+			GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+			++stats.drawCount;
+		} else {
+			drawQueue(RenderQueue::transparentPass);
+		}
+
+		GLState::depthMask(GL_TRUE);
+
+		// Blend the average transparent color over the opaque result by how much of it is covered
+		GLState::bindFramebuffer(fbo);
+		GLState::setEnabled(GL_DEPTH_TEST, false);
+		glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
+
+		GLState::useProgram(compositeProgram->getProgram());
+		GLState::bindTextureUnit(0, fboAccumulationTexture);
+		GLState::bindTextureUnit(1, fboRevealageTexture);
+
+		const auto& planeMesh = unitPlane->getMesh();
+		glDrawElementsBaseVertex(GL_TRIANGLES, planeMesh.count, GL_UNSIGNED_INT, reinterpret_cast<GLvoid*>(planeMesh.firstIndex * sizeof(GLuint)), planeMesh.baseVertex);
+
+		GLState::setEnabled(GL_BLEND, false);
+		GLState::setEnabled(GL_DEPTH_TEST, true);
+	};
+
+	void RendererForward::buildCommands() {
+		buildObjects();
+
+		// One draw command per batch, the cull shader fills in the instance counts
+		commands.resize(batches.size());
+		lodErrors.resize(batches.size());
+		GLuint instanceCount = 0;
+
+		for (size_t i = 0; i < batches.size(); ++i) {
+			const auto& lod = batches[i].submesh->lods[batches[i].lod];
+			commands[i] = {lod.mesh.count, 0, lod.mesh.firstIndex, lod.mesh.baseVertex, batches[i].firstInstance};
+			lodErrors[i] = lod.error;
+			instanceCount += batches[i].instanceCount;
+		}
+
+		batchCommandCount = commands.size();
+
+		// Items culled per meshlet get their own draw command and a range of the compacted meshlet index buffer
+		meshletLookup.clear();
+		meshletData.clear();
+		meshletVertexData.clear();
+		meshletTriangleData.clear();
+		meshletWork.clear();
+		meshletInstances.clear();
+		GLuint meshletIndexCount = 0;
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			const auto& submesh = *items[i].submesh;
+
+			if (!usesMeshlets(submesh)) {
+				continue;
+			}
+
+			const auto& meshlets = submesh.meshlets;
+			const auto inserted = meshletLookup.emplace(&submesh, static_cast<GLuint>(meshletData.size()));
+
+			// Add the meshlets of each submesh once
+			if (inserted.second) {
+				const GLuint vertexOffset = static_cast<GLuint>(meshletVertexData.size());
+				const GLuint triangleOffset = static_cast<GLuint>(meshletTriangleData.size());
+
+				for (auto meshlet : meshlets) {
+					meshlet.vertexOffset += vertexOffset;
+					meshlet.triangleOffset += triangleOffset;
+					meshletData.push_back(meshlet);
+				}
+
+				meshletVertexData.insert(meshletVertexData.end(), submesh.meshletVertices.begin(), submesh.meshletVertices.end());
+				meshletTriangleData.insert(meshletTriangleData.end(), submesh.meshletTriangles.begin(), submesh.meshletTriangles.end());
+			}
+
+			// The cull shader fills in the index count
+			const GLuint command = static_cast<GLuint>(commands.size());
+			const auto& mesh = submesh.lods.front().mesh;
+			commands.push_back({0, 1, meshletIndexCount, mesh.baseVertex, instanceCount + static_cast<GLuint>(meshletInstances.size())});
+			meshletInstances.push_back(static_cast<GLuint>(i));
+			meshletIndexCount += mesh.count;
+
+			for (GLuint j = 0; j < meshlets.size(); ++j) {
+				meshletWork.push_back({static_cast<GLuint>(i), inserted.first->second + j, command, 0});
+			}
+		}
+
+		// Upload the object data and size the buffers written by the cull shader
+		glNamedBufferData(objectBuffer, objectData.size() * sizeof(ObjectData), objectData.data(), GL_STATIC_DRAW);
+		glNamedBufferData(instanceBuffer, std::max<size_t>(instanceCount + meshletInstances.size(), 1) * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+		glNamedBufferData(lodErrorBuffer, std::max<size_t>(lodErrors.size(), 1) * sizeof(GLfloat), lodErrors.data(), GL_STATIC_DRAW);
+
+		// The meshlet instances never change so they go after the instances written by the cull shader
+		if (!meshletInstances.empty()) {
+			glNamedBufferSubData(instanceBuffer, instanceCount * sizeof(GLuint), meshletInstances.size() * sizeof(GLuint), meshletInstances.data());
+			glNamedBufferData(meshletBuffer, meshletData.size() * sizeof(Meshlet), meshletData.data(), GL_STATIC_DRAW);
+			glNamedBufferData(meshletVertexBuffer, meshletVertexData.size() * sizeof(GLuint), meshletVertexData.data(), GL_STATIC_DRAW);
+			glNamedBufferData(meshletTriangleBuffer, meshletTriangleData.size() * sizeof(GLuint), meshletTriangleData.data(), GL_STATIC_DRAW);
+			glNamedBufferData(meshletWorkBuffer, meshletWork.size() * sizeof(MeshletWork), meshletWork.data(), GL_STATIC_DRAW);
+			glNamedBufferData(meshletIndexBuffer, meshletIndexCount * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+		}
+		glNamedBufferData(commandBuffer, commands.size() * sizeof(DrawCommand), nullptr, GL_DYNAMIC_COPY);
+		glNamedBufferData(commandTemplateBuffer, commands.size() * sizeof(DrawCommand), commands.data(), GL_STATIC_DRAW);
+
+	};
+
+	void RendererForward::updateTransforms() {
+		// Copy the matrices of the nodes that moved, on the GPU path also upload the range of items they cover.
+		// CPU submission uploads every item each frame in uploadFrameData.
+		size_t first = items.size();
+		size_t last = 0;
+
+		for (const auto node : scene.getChangedNodes()) {
+			for (GLuint i = nodeItems[node]; i < nodeItems[node + 1]; ++i) {
+				objectData[i].modelMatrix = scene.getWorldMatrix(node);
+				first = std::min<size_t>(first, i);
+				last = std::max<size_t>(last, i + 1);
+			}
+		}
+
+		if (submission == SubmissionMode::GPU && first < last) {
+			glNamedBufferSubData(objectBuffer, first * sizeof(ObjectData), (last - first) * sizeof(ObjectData), &objectData[first]);
+		}
+	};
+
+	void RendererForward::uploadFrameData() {
+		frameRing->beginFrame();
+
+		// Write straight into the mapping, a bound range can't be empty so there is always room for one object
+		const GLsizeiptr objectSize = std::max<GLsizeiptr>(objectData.size() * sizeof(ObjectData), sizeof(ObjectData));
+		const auto objects = frameRing->allocate(objectSize, storageAlignment);
+		std::copy(objectData.begin(), objectData.end(), reinterpret_cast<ObjectData*>(objects.data));
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, objects.buffer, objects.offset, objectSize);
+
+		const auto instances = frameRing->allocate(std::max<GLsizeiptr>(instanceData.size() * sizeof(GLuint), sizeof(GLuint)), sizeof(GLuint));
+		std::copy(instanceData.begin(), instanceData.end(), reinterpret_cast<GLuint*>(instances.data));
+		arena.setInstanceBuffer(instances.buffer, instances.offset);
+	};
+
+	void RendererForward::cullObjectsCPU(const glm::mat4& viewProjection) {
+		const size_t count = items.size();
+
+		sphereX.resize(count);
+		sphereY.resize(count);
+		sphereZ.resize(count);
+		sphereRadius.resize(count);
+		objectVisible.resize(count);
+
+		// Transform the bounding spheres into world space
+		for (size_t i = 0; i < count; ++i) {
+			const auto& modelMatrix = objectData[i].modelMatrix;
+			const auto& sphere = objectData[i].boundingSphere;
+			const glm::vec4 center = modelMatrix * glm::vec4{sphere.x, sphere.y, sphere.z, 1.0f};
+			const float scale = std::max(glm::length(glm::vec3{modelMatrix[0]}), std::max(glm::length(glm::vec3{modelMatrix[1]}), glm::length(glm::vec3{modelMatrix[2]})));
+
+			sphereX[i] = center.x;
+			sphereY[i] = center.y;
+			sphereZ[i] = center.z;
+			sphereRadius[i] = sphere.w * scale;
+		}
+
+		const Frustum frustum{viewProjection};
+		const size_t visibleCount = frustum.cullSpheres(sphereX.data(), sphereY.data(), sphereZ.data(), sphereRadius.data(), count, objectVisible.data());
+		stats.culledCount = static_cast<unsigned int>(count - visibleCount);
+	};
+
+	void RendererForward::occlusionCullObjectsCPU(const glm::mat4& viewProjection) {
+		occlusionBuffer.begin(viewProjection);
+
+		// Rasterize the visible submeshes of the occluders, skipping those that light or alpha textures pass through
+		bool hasOccluders = false;
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			const GLuint object = items[i].object;
+			const auto& submesh = *items[i].submesh;
+
+			if (scene.isOccluder(object) && objectVisible[i] && !materials.isTransparent(submesh.materialId) && !materials.isMasked(submesh.materialId)) {
+				// The submesh ranges point into the arena, the model's own indices start at its mesh
+				const auto& model = *scene.getModel(object);
+				const auto& range = submesh.lods[0].mesh;
+				occlusionBuffer.addOccluder(model.getPositions(), model.getIndices(), objectData[i].modelMatrix, range.firstIndex - model.getMesh().firstIndex, range.count);
+				hasOccluders = true;
+			}
+		}
+
+		if (!hasOccluders) {
+			return;
+		}
+
+		occlusionBuffer.rasterize();
+
+		// Test everything else against them
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (scene.isOccluder(items[i].object) || !objectVisible[i]) {
+				continue;
+			}
+
+			if (!occlusionBuffer.isVisible(items[i].submesh->bounds, objectData[i].modelMatrix)) {
+				objectVisible[i] = 0;
+				++stats.occludedCount;
+			}
+		}
+	};
+
+	void RendererForward::selectLodsCPU(const glm::vec3& viewPosition, float lodScale) {
+		objectLod.resize(items.size());
+		objectDistance.resize(items.size());
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (!objectVisible[i]) {
+				objectLod[i] = 0;
+				continue;
+			}
+
+			// Use the distance to the closest point of the bounding sphere so the error is never underestimated
+			const glm::vec3 center{sphereX[i], sphereY[i], sphereZ[i]};
+			const float distance = std::max(glm::distance(viewPosition, center) - sphereRadius[i], 0.0001f);
+			objectDistance[i] = distance;
+			const float scale = sphereRadius[i] / std::max(objectData[i].boundingSphere.w, 0.0001f);
+
+			objectLod[i] = static_cast<uint8_t>(items[i].submesh->selectLod(scale * lodScale / distance));
+		}
+	};
+
+	void RendererForward::cullObjectsGPU(const glm::mat4& viewProjection, const glm::vec3& viewPosition, float lodScale) {
+		if (items.empty()) {
+			return;
+		}
+
+		// Reset the instance counts
+		glCopyNamedBufferSubData(commandTemplateBuffer, commandBuffer, 0, 0, commands.size() * sizeof(DrawCommand));
+
+		// Read back the counts of the previous frame if the GPU is done with them, otherwise keep showing the last ones we read
+		GLsync& previousFence = cullCountFences[cullCountIndex ^ 1];
+
+		if (previousFence != nullptr && glClientWaitSync(previousFence, 0, 0) != GL_TIMEOUT_EXPIRED) {
+			glGetNamedBufferSubData(cullCountBuffers[cullCountIndex ^ 1], 0, sizeof(cullCounts), cullCounts);
+			glDeleteSync(previousFence);
+			previousFence = nullptr;
+		}
+
+		stats.culledCount = cullCounts[0];
+		stats.occludedCount = cullCounts[1];
+
+		// Counts that were never read back are dropped
+		GLsync& fence = cullCountFences[cullCountIndex];
+
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		glClearNamedBufferData(cullCountBuffers[cullCountIndex], GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+		// Cull our items and write the visible ones into their batch's instance range
+		const Frustum frustum{viewProjection};
+		const GLuint objectCount = static_cast<GLuint>(items.size());
+
+		GLState::useProgram(cullProgram->getProgram());
+		glUniform4fv(frustumPlanesLocation, 6, &frustum.getPlanes()[0][0]);
+		glUniform1uiv(objectCountLocation, 1, &objectCount);
+
+		// Cull against last frame's depth once we have it
+		glUniform1i(occlusionCullingLocation, depthPyramidValid);
+		glUniformMatrix4fv(previousViewProjectionLocation, 1, GL_FALSE, &previousViewProjection[0][0]);
+		GLState::bindTextureUnit(0, depthPyramid->getTexture());
+
+		// Pick a level of detail for each visible object
+		glUniform3fv(cullViewPositionLocation, 1, &viewPosition[0]);
+		glUniform1f(lodScaleLocation, lodScale);
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, commandBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, instanceBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, lodErrorBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, cullCountBuffers[cullCountIndex]);
+
+		glDispatchCompute((objectCount + 63) / 64, 1, 1);
+
+		// Cull the meshlets of the remaining items and compact the indices of the visible ones, one work group per meshlet
+		if (!meshletWork.empty()) {
+			const GLuint workCount = static_cast<GLuint>(meshletWork.size());
+
+			GLState::useProgram(meshletProgram->getProgram());
+			glUniform4fv(meshletFrustumPlanesLocation, 6, &frustum.getPlanes()[0][0]);
+			glUniform1uiv(meshletWorkCountLocation, 1, &workCount);
+			glUniform1i(meshletOcclusionCullingLocation, depthPyramidValid);
+			glUniformMatrix4fv(meshletPreviousViewProjectionLocation, 1, GL_FALSE, &previousViewProjection[0][0]);
+			glUniform3fv(meshletViewPositionLocation, 1, &viewPosition[0]);
+
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, meshletIndexBuffer);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, meshletBuffer);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, meshletVertexBuffer);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, meshletTriangleBuffer);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, meshletWorkBuffer);
+
+			// Stay under the minimum GL_MAX_COMPUTE_WORK_GROUP_COUNT of 65535 in each dimension
+			const GLuint groupsX = std::min(workCount, 65535u);
+			const GLuint groupsY = (workCount + groupsX - 1) / groupsX;
+			glDispatchCompute(groupsX, groupsY, 1);
+		}
+
+		// Make the results visible to the indirect draws, instanced attribute fetch, index fetch and the cull count read back
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+		GLState::bindTextureUnit(0, 0);
+
+		cullCountFences[cullCountIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		cullCountIndex ^= 1;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+// STD
+#include <algorithm>
+#include <stdexcept>
+
+// Playground
+#include <Playground/Scene.hpp>
+
+namespace Playground {
+	Scene::Scene() : firstDirty{0} {
+	}
+
+	GLuint Scene::addNode(std::shared_ptr<Model> model, const glm::vec3& translation, bool occluder, GLuint parent) {
+		const GLuint node = getNodeCount();
+
+		if (parent != noParent && parent >= node) {
+			throw std::runtime_error("The parent of a scene node must be added before it.");
+		}
+
+		translations.push_back(translation);
+		rotations.push_back(glm::quat{1.0f, 0.0f, 0.0f, 0.0f});
+		scales.push_back(glm::vec3{1.0f, 1.0f, 1.0f});
+		parents.push_back(parent);
+		worldMatrices.push_back(glm::mat4{1.0f});
+		dirty.push_back(true);
+		models.push_back(std::move(model));
+		occluders.push_back(occluder);
+
+		firstDirty = std::min(firstDirty, node);
+		return node;
+	}
+
+	void Scene::setTranslation(GLuint node, const glm::vec3& translation) {
+		translations[node] = translation;
+		markDirty(node);
+	}
+
+	void Scene::setRotation(GLuint node, const glm::quat& rotation) {
+		rotations[node] = rotation;
+		markDirty(node);
+	}
+
+	void Scene::setScale(GLuint node, const glm::vec3& scale) {
+		scales[node] = scale;
+		markDirty(node);
+	}
+
+	void Scene::update() {
+		changedNodes.clear();
+
+		const GLuint count = getNodeCount();
+
+		// Parents come before their children so a dirty parent has always been handled by the time we reach its children
+		for (GLuint i = firstDirty; i < count; ++i) {
+			const GLuint parent = parents[i];
+
+			if (parent != noParent && dirty[parent]) {
+				dirty[i] = true;
+			}
+
+			if (!dirty[i]) {
+				continue;
+			}
+
+			// Build the local matrix from translation * rotation * scale
+			glm::mat4 local = glm::mat4_cast(rotations[i]);
+			local[0] *= scales[i].x;
+			local[1] *= scales[i].y;
+			local[2] *= scales[i].z;
+			local[3] = glm::vec4{translations[i], 1.0f};
+
+			worldMatrices[i] = parent == noParent ? local : worldMatrices[parent] * local;
+			changedNodes.push_back(i);
+		}
+
+		// Only clear the flags once we are done so they can propagate to the children
+		for (const auto node : changedNodes) {
+			dirty[node] = false;
+		}
+
+		firstDirty = count;
+	}
+
+	const std::vector<GLuint>& Scene::getChangedNodes() const {
+		return changedNodes;
+	}
+
+	GLuint Scene::getNodeCount() const {
+		return static_cast<GLuint>(parents.size());
+	}
+
+	GLuint Scene::getParent(GLuint node) const {
+		return parents[node];
+	}
+
+	const std::shared_ptr<Model>& Scene::getModel(GLuint node) const {
+		return models[node];
+	}
+
+	bool Scene::isOccluder(GLuint node) const {
+		return occluders[node] != 0;
+	}
+
+	const glm::vec3& Scene::getTranslation(GLuint node) const {
+		return translations[node];
+	}
+
+	const glm::quat& Scene::getRotation(GLuint node) const {
+		return rotations[node];
+	}
+
+	const glm::vec3& Scene::getScale(GLuint node) const {
+		return scales[node];
+	}
+
+	const glm::mat4& Scene::getWorldMatrix(GLuint node) const {
+		return worldMatrices[node];
+	}
+
+	void Scene::markDirty(GLuint node) {
+		dirty[node] = true;
+		firstDirty = std::min(firstDirty, node);
+	}
+}
\ No newline at end of file
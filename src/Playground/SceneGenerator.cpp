@@ -0,0 +1,258 @@
+// STD
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+// Playground
+#include <Playground/SceneGenerator.hpp>
+#include <Playground/Playground.hpp>
+
+namespace {
+	// A model that can be instanced by name
+	struct NamedModel {
+		const char* name;
+		const char* path;
+		float scale;
+		bool occluder;
+	};
+
+	const NamedModel namedModels[] = {
+		{"cube", "models/unit_cube.obj", 1.0f, false},
+		{"teapot", "models/unit_teapot.obj", 1.0f, false},
+		{"sponza", "models/sponza.obj", 0.05f, true},
+		{"ball", "models/light_ball.obj", 0.08f, false},
+	};
+
+	Playground::Placement parsePlacement(const std::string& value) {
+		if (value == "grid") { return Playground::Placement::GRID; }
+		if (value == "random") { return Playground::Placement::RANDOM; }
+		if (value == "clustered") { return Playground::Placement::CLUSTERED; }
+
+		throw std::runtime_error("Unknown placement \"" + value + "\", expected grid, random or clustered.");
+	}
+
+	Playground::SubmissionMode parseSubmission(const std::string& value) {
+		if (value == "cpu") { return Playground::SubmissionMode::CPU; }
+		if (value == "gpu") { return Playground::SubmissionMode::GPU; }
+
+		throw std::runtime_error("Unknown submission mode \"" + value + "\", expected cpu or gpu.");
+	}
+
+	Playground::AntiAliasingMode parseAntiAliasing(const std::string& value) {
+		if (value == "none") { return Playground::AntiAliasingMode::NONE; }
+		if (value == "msaa") { return Playground::AntiAliasingMode::MSAA; }
+
+		throw std::runtime_error("Unknown anti-aliasing mode \"" + value + "\", expected none or msaa.");
+	}
+
+	template<class T>
+	T parseNumber(const std::string& name, const std::string& value) {
+		std::istringstream stream{value};
+		T number;
+
+		if (!(stream >> number) || !stream.eof()) {
+			throw std::runtime_error("Invalid value \"" + value + "\" for --" + name + ".");
+		}
+
+		return number;
+	}
+}
+
+namespace Playground {
+	SceneGenerator::SceneGenerator(const Settings& settings) :
+		settings{settings},
+		random{settings.seed} {
+	}
+
+	SceneGenerator::Settings SceneGenerator::parseArguments(int argc, char* argv[]) {
+		Settings settings;
+
+		for (int i = 1; i < argc; i += 2) {
+			const std::string argument = argv[i];
+
+			if (argument.compare(0, 2, "--") != 0) {
+				throw std::runtime_error("Unexpected argument \"" + argument + "\".\n" + getUsage());
+			}
+
+			if (i + 1 >= argc) {
+				throw std::runtime_error("Missing value for " + argument + ".\n" + getUsage());
+			}
+
+			const std::string name = argument.substr(2);
+			const std::string value = argv[i + 1];
+
+			if (name == "seed") {
+				settings.seed = parseNumber<uint32_t>(name, value);
+			} else if (name == "model") {
+				settings.model = value;
+			} else if (name == "scale") {
+				settings.modelScale = parseNumber<float>(name, value);
+			} else if (name == "objects") {
+				settings.objectCount = parseNumber<unsigned int>(name, value);
+			} else if (name == "placement") {
+				settings.objectPlacement = parsePlacement(value);
+			} else if (name == "height") {
+				settings.objectHeight = parseNumber<float>(name, value);
+			} else if (name == "lights") {
+				settings.lightCount = parseNumber<unsigned int>(name, value);
+			} else if (name == "light-placement") {
+				settings.lightPlacement = parsePlacement(value);
+			} else if (name == "light-height") {
+				settings.lightHeight = parseNumber<float>(name, value);
+			} else if (name == "extent") {
+				settings.extent = parseNumber<float>(name, value);
+			} else if (name == "clusters") {
+				settings.clusterCount = std::max(parseNumber<unsigned int>(name, value), 1u);
+			} else if (name == "submission") {
+				settings.submission = parseSubmission(value);
+			} else if (name == "aa") {
+				settings.antiAliasing = parseAntiAliasing(value);
+			} else if (name == "samples") {
+				settings.sampleCount = std::max(parseNumber<int>(name, value), 1);
+			} else {
+				throw std::runtime_error("Unknown option " + argument + ".\n" + getUsage());
+			}
+		}
+
+		if (settings.objectHeight < 0.0f || settings.lightHeight < 0.0f) {
+			throw std::runtime_error("Heights can not be negative.\n" + getUsage());
+		}
+
+		if (!(settings.extent > 0.0f)) {
+			throw std::runtime_error("The extent must be greater than zero.\n" + getUsage());
+		}
+
+		if (settings.lightCount > MAX_LIGHTS) {
+			throw std::runtime_error("At most " + std::to_string(MAX_LIGHTS) + " lights are supported.");
+		}
+
+		return settings;
+	}
+
+	std::string SceneGenerator::getUsage() {
+		return
+			"Options:\n"
+			"  --seed N                   Seed for every random choice (default 256)\n"
+			"  --model NAME|PATH          cube, teapot, sponza, ball or an obj path (default: the built in scene)\n"
+			"  --scale F                  Scale of a model given by path (default 1)\n"
+			"  --objects N                Number of model instances (default 100)\n"
+			"  --placement MODE           grid, random or clustered (default grid)\n"
+			"  --height F                 Maximum instance height (default 0)\n"
+			"  --lights N                 Number of lights (default 256)\n"
+			"  --light-placement MODE     grid, random or clustered (default grid)\n"
+			"  --light-height F           Maximum light height (default 20)\n"
+			"  --extent F                 Half size of the placement area (default 80)\n"
+			"  --clusters N               Number of clusters for clustered placement (default 8)\n"
+			"  --submission MODE          cpu or gpu, how the renderer culls and submits draws (default cpu)\n"
+			"  --aa MODE                  none or msaa (default none)\n"
+			"  --samples N                Samples per pixel for msaa (default 4)";
+	}
+
+	void SceneGenerator::generate(AssetManager& assets, Scene& scene, std::vector<PointLight>& lights) {
+		// Setup our light data
+		std::uniform_real_distribution<float> colorDistribution{0.0f, 1.0f};
+
+		for (const auto& position : place(settings.lightPlacement, settings.lightCount, settings.lightHeight)) {
+			const float r = colorDistribution(random);
+			const float g = colorDistribution(random);
+			const float b = colorDistribution(random);
+
+			lights.push_back({position, {r, g, b}, 5.0f});
+		}
+
+		// The floor is always there
+		scene.addNode(assets.getModel("models/unit_plane_flat.obj", 1000.0f), glm::vec3{0.0f, -0.1f, 0.0f}, true);
+
+		if (settings.model.empty()) {
+			scene.addNode(assets.getModel("models/unit_cube.obj", 1.0f), glm::vec3{0.0f, 4.0f, 0.0f});
+			scene.addNode(assets.getModel("models/sponza.obj", 0.05f), glm::vec3{0.0f, 0.0f, 0.0f}, true);
+		} else {
+			const auto named = std::find_if(std::begin(namedModels), std::end(namedModels), [this](const NamedModel& model) {
+				return settings.model == model.name;
+			});
+
+			const bool isNamed = named != std::end(namedModels);
+			const auto model = isNamed ? assets.getModel(named->path, named->scale) : assets.getModel(settings.model, settings.modelScale);
+			const bool occluder = isNamed && named->occluder;
+
+			for (const auto& position : place(settings.objectPlacement, settings.objectCount, settings.objectHeight)) {
+				scene.addNode(model, position, occluder);
+			}
+		}
+
+		// Add objects to visualize our lights
+		const auto modelLightBall = assets.getModel("models/light_ball.obj", 0.08f);
+
+		for (const auto& light : lights) {
+			scene.addNode(modelLightBall, light.position);
+		}
+
+		std::cout << "Scene seed " << settings.seed << ": "
+			<< scene.getNodeCount() << " objects (" << settings.objectPlacement << "), "
+			<< lights.size() << " lights (" << settings.lightPlacement << ")\n";
+	}
+
+	const SceneGenerator::Settings& SceneGenerator::getSettings() const {
+		return settings;
+	}
+
+	std::vector<glm::vec3> SceneGenerator::place(Placement placement, unsigned int count, float height) {
+		std::vector<glm::vec3> positions;
+		positions.reserve(count);
+
+		const float extent = settings.extent;
+		std::uniform_real_distribution<float> areaDistribution{-extent, extent};
+		std::uniform_real_distribution<float> heightDistribution{0.0f, height};
+
+		switch (placement) {
+			case Placement::GRID: {
+				// Fill rows of a square grid, placing each item at the low corner of its cell like the original 16x16 light grid
+				const unsigned int side = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(count))));
+				const float spacing = side > 0 ? 2.0f * extent / side : 0.0f;
+
+				for (unsigned int i = 0; i < count; ++i) {
+					const float x = -extent + spacing * (i % side);
+					const float z = -extent + spacing * (i / side);
+					positions.push_back({x, heightDistribution(random), z});
+				}
+
+				break;
+			}
+			case Placement::RANDOM: {
+				for (unsigned int i = 0; i < count; ++i) {
+					const float x = areaDistribution(random);
+					const float z = areaDistribution(random);
+					positions.push_back({x, heightDistribution(random), z});
+				}
+
+				break;
+			}
+			case Placement::CLUSTERED: {
+				// Items are normally distributed around randomly placed centers
+				std::vector<glm::vec2> centers;
+
+				for (unsigned int i = 0; i < settings.clusterCount; ++i) {
+					const float x = areaDistribution(random);
+					const float z = areaDistribution(random);
+					centers.push_back({x, z});
+				}
+
+				std::uniform_int_distribution<size_t> clusterDistribution{0, centers.size() - 1};
+				std::normal_distribution<float> offsetDistribution{0.0f, extent / (2.0f * std::sqrt(static_cast<float>(centers.size())))};
+
+				for (unsigned int i = 0; i < count; ++i) {
+					const glm::vec2 center = centers[clusterDistribution(random)];
+					const float x = glm::clamp(center.x + offsetDistribution(random), -extent, extent);
+					const float z = glm::clamp(center.y + offsetDistribution(random), -extent, extent);
+					positions.push_back({x, heightDistribution(random), z});
+				}
+
+				break;
+			}
+		}
+
+		return positions;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,324 @@
+// STD
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+
+// Playground
+#include <Playground/ShaderProgram.hpp>
+#include <Playground/Playground.hpp>
+#include <Playground/GLState.hpp>
+
+namespace {
+	// 'PGPB' in a little endian file
+	constexpr uint32_t cacheMagic = 0x42504750;
+
+	// GL_COMPLETION_STATUS_KHR from GL_KHR_parallel_shader_compile, our loader only knows core
+	constexpr GLenum completionStatus = 0x91B1;
+
+	bool supportsParallelCompile() {
+		static const bool supported = []() {
+			GLint count = 0;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+			for (GLint i = 0; i < count; ++i) {
+				const auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+
+				if (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 || std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0) {
+					return true;
+				}
+			}
+
+			return false;
+		}();
+
+		return supported;
+	}
+
+	void writeUint(std::ofstream& file, uint32_t value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	std::string getDirectory(const std::string& path) {
+		const auto separator = path.find_last_of('/');
+		return separator == std::string::npos ? std::string{} : path.substr(0, separator + 1);
+	}
+
+	uint32_t readUint(std::ifstream& file) {
+		uint32_t value = 0;
+		file.read(reinterpret_cast<char*>(&value), sizeof(value));
+		return value;
+	}
+}
+
+namespace Playground {
+	ShaderProgram::ShaderProgram(const std::vector<Stage>& stages, const std::vector<Define>& defines) :
+		program{glCreateProgram()},
+		linked{false},
+		finished{false} {
+
+		// The defines are part of the sources so every variant gets its own cache file
+		std::vector<std::string> sources;
+
+		for (const auto& stage : stages) {
+			sources.push_back(addDefines(addIncludes(loadFile(stage.path), stage.path), defines));
+		}
+
+		cachePath = getCachePath(stages, sources);
+
+		if (loadBinary(cachePath)) {
+			linked = true;
+			finished = true;
+			return;
+		}
+
+		// Only start compiling, the driver can work on every program we create before anything asks for the result
+		link(stages, sources);
+	}
+
+	ShaderProgram::~ShaderProgram() {
+		glDeleteProgram(program);
+		GLState::invalidate();
+	}
+
+	GLuint ShaderProgram::getProgram() const {
+		return program;
+	}
+
+	bool ShaderProgram::isReady() {
+		if (finished) {
+			return true;
+		}
+
+		// Without the extension there is no way to ask without waiting
+		if (supportsParallelCompile()) {
+			GLint complete = GL_FALSE;
+			glGetProgramiv(program, completionStatus, &complete);
+
+			if (!complete) {
+				return false;
+			}
+		}
+
+		finish();
+		return true;
+	}
+
+	bool ShaderProgram::isLinked() {
+		if (!finished) {
+			finish();
+		}
+
+		return linked;
+	}
+
+	GLint ShaderProgram::getUniformLocation(const std::string& name) {
+		if (!finished) {
+			finish();
+		}
+
+		const auto found = uniformLocations.find(name);
+
+		if (found != uniformLocations.end()) {
+			return found->second;
+		}
+
+		const GLint location = glGetUniformLocation(program, name.c_str());
+		uniformLocations.emplace(name, location);
+		return location;
+	}
+
+	std::string ShaderProgram::addIncludes(const std::string& source, const std::string& path, int depth) {
+		// Includes may include other files, anything deeper than this is almost certainly a cycle
+		if (depth > 16) {
+			throw std::runtime_error("Shader includes nested too deeply in \"" + path + "\".");
+		}
+
+		std::istringstream stream{source};
+		std::string result;
+		std::string line;
+		int lineNumber = 0;
+
+		while (std::getline(stream, line)) {
+			++lineNumber;
+
+			const auto start = line.find_first_not_of(" \t");
+			const auto open = line.find('"');
+			const auto close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+
+			if (start == std::string::npos || line.compare(start, 8, "#include") != 0 || close == std::string::npos) {
+				result += line + "\n";
+				continue;
+			}
+
+			// Number the included lines from one and resume the line numbers of this file after them
+			const auto includePath = getDirectory(path) + line.substr(open + 1, close - open - 1);
+			result += "#line 1\n";
+			result += addIncludes(loadFile(includePath), includePath, depth + 1);
+			result += "#line " + std::to_string(lineNumber + 1) + "\n";
+		}
+
+		return result;
+	}
+
+	std::string ShaderProgram::addDefines(const std::string& source, const std::vector<Define>& defines) {
+		if (defines.empty()) {
+			return source;
+		}
+
+		// Nothing but comments may come before #version so the defines go right after it
+		const auto version = source.find("#version");
+		const auto lineEnd = version == std::string::npos ? std::string::npos : source.find('\n', version);
+
+		if (lineEnd == std::string::npos) {
+			throw std::runtime_error("Shader source without a #version line can't be specialized.");
+		}
+
+		std::string result = source.substr(0, lineEnd + 1);
+
+		for (const auto& define : defines) {
+			result += "#define " + define.name + " " + define.value + "\n";
+		}
+
+		// Keep the line numbers in compile errors matching the file
+		const auto versionLine = std::count(source.begin(), source.begin() + lineEnd, '\n') + 1;
+		result += "#line " + std::to_string(versionLine + 1) + "\n";
+		result += source.substr(lineEnd + 1);
+
+		return result;
+	}
+
+	std::string ShaderProgram::getCachePath(const std::vector<Stage>& stages, const std::vector<std::string>& sources) {
+
+		// 64 bit FNV-1a of everything that changes the binary, a driver update invalidates every binary it made
+		uint64_t hash = 14695981039346656037ull;
+
+		const auto mix = [&hash](const std::string& value) {
+			for (const char byte : value) {
+				hash = (hash ^ static_cast<uint8_t>(byte)) * 1099511628211ull;
+			}
+
+			// Separate the values so moving text between them changes the hash
+			hash = (hash ^ 0xFF) * 1099511628211ull;
+		};
+
+		for (size_t i = 0; i < stages.size(); ++i) {
+			mix(std::to_string(stages[i].type));
+			mix(sources[i]);
+		}
+
+		for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+			mix(reinterpret_cast<const char*>(glGetString(name)));
+		}
+
+		std::ostringstream cachePath;
+		cachePath << getDirectory(stages.front().path) << std::setfill('0') << std::setw(16) << std::hex << hash << ".programcache";
+		return cachePath.str();
+	}
+
+	bool ShaderProgram::loadBinary(const std::string& cachePath) {
+		std::ifstream file{cachePath, std::ios::in | std::ios::binary};
+
+		if (!file || readUint(file) != cacheMagic || readUint(file) != cacheVersion) {
+			return false;
+		}
+
+		const GLenum format = readUint(file);
+		std::vector<char> binary(readUint(file));
+		file.read(binary.data(), binary.size());
+
+		if (!file || binary.empty()) {
+			return false;
+		}
+
+		// The driver may still reject a binary it made, if so we link from source as if there was no cache
+		glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+		GLint success = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		return success != 0;
+	}
+
+	void ShaderProgram::saveBinary(const std::string& cachePath) const {
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+		// Drivers without any binary formats report no length
+		if (length <= 0) {
+			return;
+		}
+
+		GLenum format;
+		std::vector<char> binary(length);
+		glGetProgramBinary(program, length, &length, &format, binary.data());
+
+		// Write to a temporary file first so a crash or another process never sees a partial cache file
+		const auto tempPath = cachePath + ".tmp";
+
+		{
+			std::ofstream file{tempPath, std::ios::out | std::ios::binary | std::ios::trunc};
+
+			if (!file) {
+				std::cout << "[WARNING] Unable to write program cache \"" << cachePath << "\".\n";
+				return;
+			}
+
+			writeUint(file, cacheMagic);
+			writeUint(file, cacheVersion);
+			writeUint(file, format);
+			writeUint(file, static_cast<uint32_t>(length));
+			file.write(binary.data(), length);
+		}
+
+		if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+			std::remove(tempPath.c_str());
+		}
+	}
+
+	void ShaderProgram::link(const std::vector<Stage>& stages, const std::vector<std::string>& sources) {
+		// Querying anything about the shaders here would wait for them, errors are checked in finish
+		for (size_t i = 0; i < stages.size(); ++i) {
+			const GLuint shader = glCreateShader(stages[i].type);
+			const GLchar* sourcePtr = sources[i].c_str();
+
+			glShaderSource(shader, 1, &sourcePtr, nullptr);
+			glCompileShader(shader);
+
+			glAttachShader(program, shader);
+			shaders.push_back(shader);
+		}
+
+		// Ask the driver to keep the binary around so we can cache it
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(program);
+	}
+
+	void ShaderProgram::finish() {
+		for (const auto shader : shaders) {
+			checkShaderSuccess(shader);
+		}
+
+		checkLinkStatus(program);
+
+		// Detach and delete shaders
+		for (const auto shader : shaders) {
+			glDetachShader(program, shader);
+			glDeleteShader(shader);
+		}
+
+		shaders.clear();
+
+		GLint success = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		linked = success != 0;
+		finished = true;
+
+		if (linked) {
+			saveBinary(cachePath);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+// Playground
+#include <Playground/ShaderVariants.hpp>
+
+namespace Playground {
+	ShaderVariants::ShaderVariants(const std::vector<ShaderProgram::Stage>& stages) :
+		stages{stages} {
+	}
+
+	ShaderProgram& ShaderVariants::get(const std::vector<ShaderProgram::Define>& defines) {
+		if (defines.empty()) {
+			return getFallback();
+		}
+
+		std::string key;
+
+		for (const auto& define : defines) {
+			key += define.name + "=" + define.value + ";";
+		}
+
+		auto& variant = variants[key];
+
+		if (!variant) {
+			variant = std::make_unique<ShaderProgram>(stages, defines);
+		}
+
+		// Only a finished variant can have failed, asking before that would wait for it
+		if (variant->isReady() && !variant->isLinked()) {
+			return getFallback();
+		}
+
+		return *variant;
+	}
+
+	ShaderProgram& ShaderVariants::getFallback() {
+		auto& fallback = variants[""];
+
+		if (!fallback) {
+			fallback = std::make_unique<ShaderProgram>(stages);
+		}
+
+		return *fallback;
+	}
+}
\ No newline at end of file
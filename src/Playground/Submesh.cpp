@@ -0,0 +1,14 @@
+// Playground
+#include <Playground/Submesh.hpp>
+
+namespace Playground {
+	size_t Submesh::selectLod(float errorScale) const {
+		size_t lod = 0;
+
+		while (lod + 1 < lods.size() && lods[lod + 1].error * errorScale <= 1.0f) {
+			++lod;
+		}
+
+		return lod;
+	}
+}
\ No newline at end of file
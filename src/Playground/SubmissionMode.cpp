@@ -0,0 +1,25 @@
+// STD
+#include <string>
+
+// Playground
+#include <Playground/SubmissionMode.hpp>
+
+std::ostream& operator<<(std::ostream& os, const Playground::SubmissionMode mode) {
+	std::string str;
+
+	switch (mode) {
+		case Playground::SubmissionMode::CPU:
+			str = "Playground::SubmissionMode::CPU";
+			break;
+		case Playground::SubmissionMode::GPU:
+			str = "Playground::SubmissionMode::GPU";
+			break;
+		default:
+			str = "[TODO] Add ostream support for Playground::SubmissionMode::???? = "
+				+ std::to_string(static_cast<std::underlying_type_t<Playground::SubmissionMode>>(mode));
+			break;
+	}
+
+	os << str;
+	return os;
+}
\ No newline at end of file
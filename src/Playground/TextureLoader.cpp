@@ -0,0 +1,345 @@
+// STD
+#include <cmath>
+#include <cstdio>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+// SSE
+#include <xmmintrin.h>
+
+// stb
+#include <stb/stb_image.h>
+
+// Playground
+#include <Playground/TextureLoader.hpp>
+#include <Playground/BlockCompressor.hpp>
+#include <Playground/Playground.hpp>
+
+namespace {
+	// 'PGTX' in a little endian file
+	constexpr uint32_t cacheMagic = 0x58544750;
+
+	// Resolution of the table used to turn linear values back into sRGB
+	constexpr int linearTableSize = 4096;
+
+	// The value masks are tested against in the shaders
+	constexpr float maskCutoff = 0.5f;
+
+	float srgbToLinear(float value) {
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float linearToSrgb(float value) {
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	const std::array<float, 256>& getSrgbTable() {
+		static const auto table = []() {
+			std::array<float, 256> table;
+
+			for (int i = 0; i < 256; ++i) {
+				table[i] = srgbToLinear(i / 255.0f);
+			}
+
+			return table;
+		}();
+
+		return table;
+	}
+
+	const std::array<uint8_t, linearTableSize>& getLinearTable() {
+		static const auto table = []() {
+			std::array<uint8_t, linearTableSize> table;
+
+			for (int i = 0; i < linearTableSize; ++i) {
+				table[i] = static_cast<uint8_t>(std::round(linearToSrgb(i / (linearTableSize - 1.0f)) * 255.0f));
+			}
+
+			return table;
+		}();
+
+		return table;
+	}
+
+	// The fraction of texels whose scaled mask passes the cutoff
+	float getCoverage(const std::vector<float>& texels, float scale) {
+		size_t covered = 0;
+
+		for (size_t i = 0; i < texels.size(); i += 4) {
+			covered += texels[i] * scale >= maskCutoff;
+		}
+
+		return static_cast<float>(covered) / (texels.size() / 4);
+	}
+
+	// Finds the scale that makes the mask of a level cover as much as the most detailed one, coverage only grows with the scale
+	float findCoverageScale(const std::vector<float>& texels, float coverage) {
+		float low = 0.0f;
+		float high = 4.0f;
+
+		for (int i = 0; i < 12; ++i) {
+			const float middle = (low + high) * 0.5f;
+
+			if (getCoverage(texels, middle) < coverage) {
+				low = middle;
+			} else {
+				high = middle;
+			}
+		}
+
+		return (low + high) * 0.5f;
+	}
+
+	uint8_t toUnorm(float value) {
+		return static_cast<uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+	}
+
+	void writeUint(std::ofstream& file, uint32_t value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	uint32_t readUint(std::ifstream& file) {
+		uint32_t value = 0;
+		file.read(reinterpret_cast<char*>(&value), sizeof(value));
+		return value;
+	}
+}
+
+namespace Playground {
+	TextureData TextureLoader::load(const std::string& path, TextureUsage usage) {
+		TextureData texture{GL_RGBA8, false, 0, 0, {}};
+		std::string contents;
+
+		try {
+			contents = loadFile(path);
+		} catch (const std::runtime_error& error) {
+			std::cout << "[WARNING] " << error.what() << "\n";
+			return texture;
+		}
+
+		const auto cachePath = getCachePath(path, contents, usage);
+
+		if (readCache(cachePath, texture)) {
+			return texture;
+		}
+
+		int width;
+		int height;
+		int channels;
+		stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(contents.data()),
+			static_cast<int>(contents.size()), &width, &height, &channels, 4);
+
+		if (pixels == nullptr) {
+			std::cout << "[WARNING] Unable to load texture \"" << path << "\": " << stbi_failure_reason() << "\n";
+			return texture;
+		}
+
+		// OpenGL expects the bottom row first. The stb flag for this is global so we flip it ourselves.
+		const size_t rowSize = width * 4;
+		texture.width = width;
+		texture.height = height;
+		texture.levels.emplace_back(rowSize * height);
+
+		for (int y = 0; y < height; ++y) {
+			std::copy_n(pixels + (height - 1 - y) * rowSize, rowSize, texture.levels[0].begin() + y * rowSize);
+		}
+
+		stbi_image_free(pixels);
+
+		// Blocks are 4x4 so anything else is stored uncompressed
+		texture.compressed = width % 4 == 0 && height % 4 == 0;
+
+		switch (usage) {
+			case TextureUsage::COLOR:
+				texture.format = texture.compressed ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_SRGB8_ALPHA8;
+				break;
+			case TextureUsage::MASK:
+				texture.format = texture.compressed ? GL_COMPRESSED_RED_RGTC1 : GL_RGBA8;
+				break;
+			case TextureUsage::NORMAL:
+				texture.format = texture.compressed ? GL_COMPRESSED_RG_RGTC2 : GL_RGBA8;
+				break;
+		}
+
+		buildMipChain(texture, usage);
+
+		if (texture.compressed) {
+			for (size_t level = 0; level < texture.levels.size(); ++level) {
+				const int levelWidth = std::max(width >> level, 1);
+				const int levelHeight = std::max(height >> level, 1);
+				texture.levels[level] = BlockCompressor::compress(texture.levels[level].data(), levelWidth, levelHeight, texture.format);
+			}
+		}
+
+		writeCache(cachePath, texture);
+		return texture;
+	}
+
+	std::string TextureLoader::getCachePath(const std::string& path, const std::string& contents, TextureUsage usage) {
+		// 64 bit FNV-1a of the image along with everything else that changes the output
+		uint64_t hash = 14695981039346656037ull;
+
+		const auto mix = [&hash](uint8_t byte) {
+			hash = (hash ^ byte) * 1099511628211ull;
+		};
+
+		for (const char byte : contents) {
+			mix(static_cast<uint8_t>(byte));
+		}
+
+		mix(static_cast<uint8_t>(usage));
+
+		for (int i = 0; i < 4; ++i) {
+			mix(static_cast<uint8_t>(cacheVersion >> (i * 8)));
+		}
+
+		const auto separator = path.find_last_of('/');
+		const auto directory = separator == std::string::npos ? std::string{} : path.substr(0, separator + 1);
+
+		std::ostringstream cachePath;
+		cachePath << directory << std::setfill('0') << std::setw(16) << std::hex << hash << ".texcache";
+		return cachePath.str();
+	}
+
+	bool TextureLoader::readCache(const std::string& cachePath, TextureData& texture) {
+		std::ifstream file{cachePath, std::ios::in | std::ios::binary};
+
+		if (!file || readUint(file) != cacheMagic || readUint(file) != cacheVersion) {
+			return false;
+		}
+
+		texture.format = readUint(file);
+		texture.compressed = readUint(file) != 0;
+		texture.width = readUint(file);
+		texture.height = readUint(file);
+		texture.levels.resize(readUint(file));
+
+		for (auto& level : texture.levels) {
+			level.resize(readUint(file));
+			file.read(reinterpret_cast<char*>(level.data()), level.size());
+		}
+
+		// A truncated file is treated as a miss and rebuilt
+		if (!file || texture.levels.empty()) {
+			texture.levels.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	void TextureLoader::writeCache(const std::string& cachePath, const TextureData& texture) {
+		// Write to a temporary file first so a crash or another process never sees a partial cache file
+		const auto tempPath = cachePath + ".tmp";
+
+		{
+			std::ofstream file{tempPath, std::ios::out | std::ios::binary | std::ios::trunc};
+
+			if (!file) {
+				std::cout << "[WARNING] Unable to write texture cache \"" << cachePath << "\".\n";
+				return;
+			}
+
+			writeUint(file, cacheMagic);
+			writeUint(file, cacheVersion);
+			writeUint(file, texture.format);
+			writeUint(file, texture.compressed);
+			writeUint(file, texture.width);
+			writeUint(file, texture.height);
+			writeUint(file, static_cast<uint32_t>(texture.levels.size()));
+
+			for (const auto& level : texture.levels) {
+				writeUint(file, static_cast<uint32_t>(level.size()));
+				file.write(reinterpret_cast<const char*>(level.data()), level.size());
+			}
+		}
+
+		if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+			std::remove(tempPath.c_str());
+		}
+	}
+
+	void TextureLoader::buildMipChain(TextureData& texture, TextureUsage usage) {
+		const auto& srgbTable = getSrgbTable();
+		const auto& linearTable = getLinearTable();
+		const bool srgb = usage == TextureUsage::COLOR;
+
+		int width = texture.width;
+		int height = texture.height;
+
+		// Filter in linear floating point and keep the full precision between levels
+		std::vector<float> current(width * height * 4);
+		const auto& base = texture.levels[0];
+
+		for (size_t i = 0; i < current.size(); ++i) {
+			current[i] = srgb && i % 4 != 3 ? srgbTable[base[i]] : base[i] / 255.0f;
+		}
+
+		std::vector<float> next;
+		const __m128 quarter = _mm_set1_ps(0.25f);
+
+		// Averaging blurs a mask towards its mean so cutouts thin out or grow on less detailed levels unless we rescale them
+		const float coverage = usage == TextureUsage::MASK ? getCoverage(current, 1.0f) : 0.0f;
+
+		while (width > 1 || height > 1) {
+			const int nextWidth = std::max(width / 2, 1);
+			const int nextHeight = std::max(height / 2, 1);
+			next.resize(nextWidth * nextHeight * 4);
+
+			for (int y = 0; y < nextHeight; ++y) {
+				// Odd and single texel dimensions reuse the last row or column
+				const float* row0 = &current[(y * 2) * width * 4];
+				const float* row1 = &current[std::min(y * 2 + 1, height - 1) * width * 4];
+
+				for (int x = 0; x < nextWidth; ++x) {
+					const int x0 = x * 2 * 4;
+					const int x1 = std::min(x * 2 + 1, width - 1) * 4;
+
+					// One texel is one register, average the four texels of the footprint
+					__m128 sum = _mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1));
+					sum = _mm_add_ps(sum, _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+
+					float* texel = &next[(y * nextWidth + x) * 4];
+					_mm_storeu_ps(texel, _mm_mul_ps(sum, quarter));
+
+					// Averaged normals get shorter, bring them back to unit length
+					if (usage == TextureUsage::NORMAL) {
+						const float nx = texel[0] * 2.0f - 1.0f;
+						const float ny = texel[1] * 2.0f - 1.0f;
+						const float nz = texel[2] * 2.0f - 1.0f;
+						const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+
+						if (length > 0.0f) {
+							texel[0] = (nx / length) * 0.5f + 0.5f;
+							texel[1] = (ny / length) * 0.5f + 0.5f;
+							texel[2] = (nz / length) * 0.5f + 0.5f;
+						}
+					}
+				}
+			}
+
+			std::vector<uint8_t> level(next.size());
+			const float maskScale = usage == TextureUsage::MASK ? findCoverageScale(next, coverage) : 1.0f;
+
+			for (size_t i = 0; i < next.size(); ++i) {
+				if (i % 4 == 0 && usage == TextureUsage::MASK) {
+					level[i] = toUnorm(next[i] * maskScale);
+				} else if (srgb && i % 4 != 3) {
+					const float value = std::min(std::max(next[i], 0.0f), 1.0f);
+					level[i] = linearTable[static_cast<int>(value * (linearTableSize - 1) + 0.5f)];
+				} else {
+					level[i] = toUnorm(next[i]);
+				}
+			}
+
+			texture.levels.push_back(std::move(level));
+			current.swap(next);
+			width = nextWidth;
+			height = nextHeight;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+// STD
+#include <string>
+
+// Playground
+#include <Playground/TextureUsage.hpp>
+
+std::ostream& operator<<(std::ostream& os, const Playground::TextureUsage usage) {
+	std::string str;
+
+	switch (usage) {
+		case Playground::TextureUsage::COLOR:
+			str = "Playground::TextureUsage::COLOR";
+			break;
+		case Playground::TextureUsage::MASK:
+			str = "Playground::TextureUsage::MASK";
+			break;
+		case Playground::TextureUsage::NORMAL:
+			str = "Playground::TextureUsage::NORMAL";
+			break;
+		default:
+			str = "[TODO] Add ostream support for Playground::TextureUsage::???? = "
+				+ std::to_string(static_cast<std::underlying_type_t<Playground::TextureUsage>>(usage));
+			break;
+	}
+
+	os << str;
+	return os;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+// STD
+#include <algorithm>
+
+// Playground
+#include <Playground/ThreadPool.hpp>
+
+namespace Playground {
+	ThreadPool::ThreadPool(unsigned int threadCount) : stopping{false} {
+		threadCount = std::max(threadCount, 1u);
+
+		for (unsigned int i = 0; i < threadCount; ++i) {
+			threads.emplace_back(&ThreadPool::work, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			stopping = true;
+		}
+
+		condition.notify_all();
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	unsigned int ThreadPool::getThreadCount() const {
+		return static_cast<unsigned int>(threads.size());
+	}
+
+	unsigned int ThreadPool::getDefaultThreadCount() {
+		const unsigned int cores = std::thread::hardware_concurrency();
+		return cores > 1 ? cores - 1 : 1;
+	}
+
+	void ThreadPool::work() {
+		while (true) {
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock{mutex};
+				condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+				// Finish any remaining tasks before stopping
+				if (tasks.empty()) {
+					return;
+				}
+
+				task = std::move(tasks.front());
+				tasks.pop();
+			}
+
+			task();
+		}
+	}
+}
\ No newline at end of file
@@ -23,18 +23,28 @@
 #define TINYOBJLOADER_IMPLEMENTATION // NOTE: Only define this once
 #include <tinyobjloader/tiny_obj_loader.h>
 
+// stb
+#define STB_IMAGE_IMPLEMENTATION // NOTE: Only define this once
+#include <stb/stb_image.h>
+
 // Playground
 #include <Playground/Playground.hpp>
 #include <Playground/Vertex.hpp>
 #include <Playground/Model.hpp>
+#include <Playground/GeometryArena.hpp>
+#include <Playground/AssetManager.hpp>
+#include <Playground/ThreadPool.hpp>
 #include <Playground/Camera.hpp>
 #include <Playground/Renderer.hpp>
 #include <Playground/RendererForward.hpp>
 #include <Playground/PointLight.hpp>
-#include <Playground/Renderable.hpp>
+#include <Playground/Scene.hpp>
 #include <Playground/AntiAliasingMode.hpp>
+#include <Playground/SubmissionMode.hpp>
+#include <Playground/SceneGenerator.hpp>
+#include <Playground/GLState.hpp>
 
-void run(GLFWwindow* window) {
+void run(GLFWwindow* window, const Playground::SceneGenerator::Settings& settings) {
 	int windowWidth;
 	int windowHeight;
 	glfwGetWindowSize(window, &windowWidth, &windowHeight);
@@ -42,72 +52,74 @@ void run(GLFWwindow* window) {
 	Playground::printInfo();
 
 	// General GL stuff
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_FRAMEBUFFER_SRGB);
-	glEnable(GL_CULL_FACE);
+	Playground::GLState::setEnabled(GL_DEPTH_TEST, true);
+	Playground::GLState::setEnabled(GL_FRAMEBUFFER_SRGB, true);
+	Playground::GLState::setEnabled(GL_CULL_FACE, true);
 	glFrontFace(GL_CCW);
 
-	// Setup our light data
-	std::vector<Playground::PointLight> lights;
+	// Setup the shared geometry storage for our models
+	Playground::GeometryArena arena{};
 
-	srand(256); // Seed rand so we always get the same results
-
-	for (int x = -8; x < 8; ++x) {
-		for (int z = -8; z < 8; ++z) {
-			const float scale = 10.0f;
-			float r = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-			float g = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-			float b = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-			float y = (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 20.0f;
-
-			lights.push_back({
-				{static_cast<float>(x * scale), y, static_cast<float>(z * scale)},
-				{r, g, b},
-				5.0f
-			});
-		}
-	}
+	// Worker threads shared by asset loading and the renderer
+	Playground::ThreadPool pool{};
 
-	// Load our models
-	auto modelUnitCube = std::make_shared<Playground::Model>("models/unit_cube.obj", 1.0f);
-	auto modelUnitPlane = std::make_shared<Playground::Model>("models/unit_plane_flat.obj", 1000.0f);
-	auto modelLightBall = std::make_shared<Playground::Model>("models/light_ball.obj", 0.08f);
-	auto modelSponza = std::make_shared<Playground::Model>("models/sponza.obj", 0.05f);
-
-	// Setup our objects
-	std::vector<Playground::Renderable> objects {
-		{modelUnitCube, glm::vec3{0.0f, 4.0f, 0.0f}},
-		{modelUnitPlane, glm::vec3{0.0f, -0.1f, 0.0f}},
-		{modelSponza, glm::vec3{0.0f, 0.0f, 0.0f}},
-	};
-
-	// Add objects to visualize our lights
-	for (const auto& light : lights) {
-		objects.push_back({modelLightBall, light.position});
-	}
+	// Generate our scene, its models load in the background and objects are drawn as they finish
+	Playground::AssetManager assets{arena, pool};
+	Playground::Scene scene;
+	std::vector<Playground::PointLight> lights;
+	Playground::SceneGenerator{settings}.generate(assets, scene, lights);
 
 	// Renderer
-	auto renderer = std::make_shared<Playground::RendererForward>(windowWidth, windowHeight, Playground::AntiAliasingMode::NONE, 1, 2, objects, lights);
+	auto renderer = std::make_shared<Playground::RendererForward>(windowWidth, windowHeight, settings.antiAliasing, settings.sampleCount, 2, settings.submission, assets, pool, scene, lights);
 
 
 	// Setup our camera
 	Playground::Camera camera{window, 75.0f, 0.01f, 1000.0f};
 
+	// Frame timing
+	double lastStatsTime = glfwGetTime();
+	int framesSinceStats = 0;
+
 	// Render loop
 	while (!glfwWindowShouldClose(window)) {
+		// Upload any models that finished loading
+		assets.update();
+
 		// Update camera and matrices
 		camera.update();
+		scene.update();
 
 		// Draw the scene
 		renderer->draw(camera);
 
 		// Copy over our frame buffer
-		glViewport(0, 0, windowWidth, windowHeight);
+		Playground::GLState::viewport(0, 0, windowWidth, windowHeight);
 		glBlitNamedFramebuffer(renderer->getFrameBuffer(), 0,
 			0, 0, windowWidth, windowHeight,
 			0, 0, windowWidth, windowHeight,
 			GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
+		// Display our frame stats once a second
+		++framesSinceStats;
+		const double currentTime = glfwGetTime();
+
+		if (currentTime - lastStatsTime >= 1.0) {
+			const auto& stats = renderer->getFrameStats();
+			const double frameTime = (currentTime - lastStatsTime) * 1000.0 / framesSinceStats;
+
+			std::stringstream title;
+			title << "AA Playground - " << std::fixed << std::setprecision(2) << frameTime << " ms"
+				<< " | Draws: " << stats.drawCount
+				<< " | Culled: " << stats.culledCount << "/" << stats.submeshCount
+				<< " | Occluded: " << stats.occludedCount
+				<< " | State calls: " << stats.stateCallCount << " (" << stats.redundantStateCount << " skipped)";
+
+			glfwSetWindowTitle(window, title.str().c_str());
+
+			lastStatsTime = currentTime;
+			framesSinceStats = 0;
+		}
+
 		// Other
 		glfwSwapBuffers(window);
 		glfwPollEvents();
@@ -122,10 +134,19 @@ void run(GLFWwindow* window) {
 
 	
 int main(int argc, char* argv[]) {
+	Playground::SceneGenerator::Settings settings;
+
+	try {
+		settings = Playground::SceneGenerator::parseArguments(argc, argv);
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
 	Playground::setup();
 
 	auto window = Playground::getNewWindow("AA Playground");
-	run(window);
+	run(window, settings);
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,23 @@
+#version 450 core
+
+in vec2 fragTexCoord; // The texture coordinates of this fragment
+
+layout(binding = 0) uniform sampler2D accumulation; // The weighted sum of premultiplied transparent colors and their weights
+layout(binding = 1) uniform sampler2D revealage; // The product of the transmittance of every transparent surface
+
+out vec4 finalColor; // The average transparent color and how much of the opaque color shows through it
+
+void main() {
+	const ivec2 texel = ivec2(gl_FragCoord.xy);
+	const float revealed = texelFetch(revealage, texel, 0).r;
+
+	// Nothing transparent was drawn here
+	if (revealed >= 1.0) {
+		discard;
+	}
+
+	const vec4 sum = texelFetch(accumulation, texel, 0);
+
+	// Divide out the weights to get the weighted average color
+	finalColor = vec4(sum.rgb / clamp(sum.a, 0.0001, 50000.0), revealed);
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+// The frustum and occlusion tests shared by the cull shaders, included after the #version line
+
+layout(binding = 0) uniform sampler2D depthPyramid; // The hierarchical depth of the previous frame
+
+uniform vec4 frustumPlanes[6]; // The world space frustum planes
+uniform bool occlusionCulling; // If depthPyramid holds valid depth
+uniform mat4 previousViewProjection; // The view projection matrix depthPyramid was rendered with
+
+bool isSphereVisible(vec3 center, float radius) {
+	for (int i = 0; i < 6; ++i) {
+		if (dot(frustumPlanes[i].xyz, center) + frustumPlanes[i].w < -radius) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool isSphereOccluded(vec3 center, float radius) {
+	// Find the screen space bounds of the sphere's bounding box as it was seen last frame
+	vec3 minNDC = vec3(1.0);
+	vec3 maxNDC = vec3(-1.0);
+
+	for (int i = 0; i < 8; ++i) {
+		const vec3 corner = center + radius * vec3(
+			(i & 1) == 0 ? -1.0 : 1.0,
+			(i & 2) == 0 ? -1.0 : 1.0,
+			(i & 4) == 0 ? -1.0 : 1.0
+		);
+
+		const vec4 clip = previousViewProjection * vec4(corner, 1.0);
+
+		// Anything crossing the near plane is treated as visible
+		if (clip.w <= 0.0) {
+			return false;
+		}
+
+		const vec3 ndc = clip.xyz / clip.w;
+
+		if (i == 0) {
+			minNDC = ndc;
+			maxNDC = ndc;
+		} else {
+			minNDC = min(minNDC, ndc);
+			maxNDC = max(maxNDC, ndc);
+		}
+	}
+
+	const vec2 minUV = clamp(minNDC.xy * 0.5 + 0.5, 0.0, 1.0);
+	const vec2 maxUV = clamp(maxNDC.xy * 0.5 + 0.5, 0.0, 1.0);
+	const float nearestDepth = minNDC.z * 0.5 + 0.5;
+
+	// Pick the level where the bounds cover at most two texels in each direction
+	const vec2 baseSize = vec2(textureSize(depthPyramid, 0));
+	const vec2 size = (maxUV - minUV) * baseSize;
+	const float levelCount = float(textureQueryLevels(depthPyramid));
+	const float level = min(ceil(log2(max(max(size.x, size.y), 1.0))), levelCount - 1.0);
+
+	// Sample the texels under each corner of the bounds
+	const float farthestDepth = max(
+		max(textureLod(depthPyramid, minUV, level).r, textureLod(depthPyramid, vec2(maxUV.x, minUV.y), level).r),
+		max(textureLod(depthPyramid, vec2(minUV.x, maxUV.y), level).r, textureLod(depthPyramid, maxUV, level).r)
+	);
+
+	return nearestDepth > farthestDepth;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#version 450 core
+
+layout(local_size_x = 64) in;
+
+struct ObjectData {
+	mat4 modelMatrix; // The model matrix of this object
+	vec4 boundingSphere; // The model space center and radius of this object
+	uint batch; // The batch this object's most detailed level is drawn in, less detailed levels follow it
+	uint lodCount; // The number of levels of detail of this object's model
+};
+
+const uint noBatch = 0xFFFFFFFF; // The batch of objects that are not drawn by a batch
+
+struct DrawCommand {
+	uint count;
+	uint instanceCount;
+	uint firstIndex;
+	int baseVertex;
+	uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Objects {
+	ObjectData objects[]; // The data of every object in our scene
+};
+
+layout(std430, binding = 1) buffer Commands {
+	DrawCommand commands[]; // One draw command per batch
+};
+
+layout(std430, binding = 2) writeonly buffer Instances {
+	uint instances[]; // The indices of the visible objects, grouped by batch
+};
+
+layout(std430, binding = 3) readonly buffer LodErrors {
+	float lodErrors[]; // The model space error of the level of detail drawn by each batch
+};
+
+layout(std430, binding = 4) buffer CullCounts {
+	uint culledCount; // The number of objects outside of the frustum
+	uint occludedCount; // The number of objects hidden behind last frame's depth
+};
+
+#include "cull_common.glsl"
+
+uniform uint objectCount; // The number of objects
+uniform vec3 viewPosition; // The world space position of the camera
+uniform float lodScale; // Converts a model space error at a distance of one unit into a multiple of the allowed screen space error
+
+void main() {
+	const uint index = gl_GlobalInvocationID.x;
+
+	if (index >= objectCount) {
+		return;
+	}
+
+	const ObjectData object = objects[index];
+
+	// Objects that are not batched are culled per meshlet instead
+	if (object.batch == noBatch) {
+		return;
+	}
+
+	// Transform the bounding sphere into world space
+	const vec3 center = vec3(object.modelMatrix * vec4(object.boundingSphere.xyz, 1.0));
+	const float scale = max(length(object.modelMatrix[0].xyz), max(length(object.modelMatrix[1].xyz), length(object.modelMatrix[2].xyz)));
+	const float radius = object.boundingSphere.w * scale;
+
+	if (!isSphereVisible(center, radius)) {
+		atomicAdd(culledCount, 1);
+		return;
+	}
+
+	if (occlusionCulling && isSphereOccluded(center, radius)) {
+		atomicAdd(occludedCount, 1);
+		return;
+	}
+
+	// Pick the least detailed level whose error is small enough, using the closest point of the bounding sphere
+	const float closestDistance = max(distance(viewPosition, center) - radius, 0.0001);
+	const float errorScale = scale * lodScale / closestDistance;
+	uint batch = object.batch;
+
+	while (batch + 1 < object.batch + object.lodCount && lodErrors[batch + 1] * errorScale <= 1.0) {
+		++batch;
+	}
+
+	// Append this object to its batch
+	const uint slot = atomicAdd(commands[batch].instanceCount, 1);
+	instances[commands[batch].baseInstance + slot] = index;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#version 450 core
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D source; // The depth buffer or the previous pyramid level
+layout(r32f, binding = 0) uniform writeonly image2D destination; // The pyramid level to write
+
+uniform int sourceLevel; // The mip level of source to read
+
+void main() {
+	const ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+	const ivec2 destinationSize = imageSize(destination);
+
+	if (any(greaterThanEqual(coord, destinationSize))) {
+		return;
+	}
+
+	// Find every source texel this texel overlaps. Sizes that are not an exact multiple can overlap up to three texels per axis.
+	const ivec2 sourceSize = textureSize(source, sourceLevel);
+	const ivec2 begin = (coord * sourceSize) / destinationSize;
+	const ivec2 end = ((coord + 1) * sourceSize + destinationSize - 1) / destinationSize;
+
+	// Keep the farthest depth so that the pyramid stays conservative
+	float depth = 0.0;
+
+	for (int y = begin.y; y < end.y; ++y) {
+		for (int x = begin.x; x < end.x; ++x) {
+			depth = max(depth, texelFetch(source, ivec2(x, y), sourceLevel).r);
+		}
+	}
+
+	imageStore(destination, coord, vec4(depth));
+}
\ No newline at end of file
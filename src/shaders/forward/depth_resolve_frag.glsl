@@ -0,0 +1,16 @@
+#version 450 core
+
+layout(binding = 0) uniform sampler2DMS depthAttachment; // The multisampled depth to resolve
+
+void main() {
+	const ivec2 texel = ivec2(gl_FragCoord.xy);
+
+	// Keep the farthest sample so the resolved depth never hides anything that is visible in part of the pixel
+	float depth = texelFetch(depthAttachment, texel, 0).r;
+
+	for (int i = 1; i < SAMPLE_COUNT; ++i) {
+		depth = max(depth, texelFetch(depthAttachment, texel, i).r);
+	}
+
+	gl_FragDepth = depth;
+}
\ No newline at end of file
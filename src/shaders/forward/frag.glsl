@@ -6,32 +6,121 @@ struct PointLight {
 	float intensity;
 };
 
+struct MaterialData {
+	vec4 diffuse; // The diffuse color and opacity
+	int diffuseTexture; // The layer in the low 16 bits, the texture array in the next 8 and the first uploaded level in the 4 above, -1 if unused
+	int alphaTexture; // The alpha mask, same encoding as diffuseTexture
+	int normalTexture; // The tangent space normal map with only x and y stored, same encoding as diffuseTexture
+};
+
 const float EPSILON = 0.000001;
 const uint MAX_LIGHTS = 1024;
+const int NO_TEXTURE = -1;
 
 in vec3 fragPosition; // The world space position of this fragment
-in vec3 fragNormal; // The normal of this fragment
+in vec3 fragNormal; // The world space normal of this fragment
 in vec3 fragColor; // The interpolated fragment color
+in vec2 fragTexCoord; // The interpolated texture coordinate
+flat in uint fragMaterial; // The material of this object
 
-layout(std140) uniform Lights {
+layout(std140, binding = 0) uniform Lights {
 	PointLight lights[MAX_LIGHTS]; // A array of all lights in our scene
 };
 
+layout(std430, binding = 1) readonly buffer Materials {
+	MaterialData materials[]; // The materials of every model
+};
+
+layout(binding = 1) uniform sampler2DArray textureArrays[8]; // The textures of every material, grouped by size and format
+
 uniform vec3 viewPosition; // The position of the view/camera
+
+// Specialized variants get these as defines so the branches and loop bounds are known at compile time
+#ifdef LIGHT_COUNT
+const uint lightCount = LIGHT_COUNT; // The number of lights
+#else
 uniform uint lightCount; // The number of lights
+#endif
+
+#ifdef ALPHA_TO_COVERAGE
+const bool alphaToCoverage = ALPHA_TO_COVERAGE; // If masked texels are cut out through the alpha of finalColor instead of discarded
+#else
+uniform bool alphaToCoverage; // If masked texels are cut out through the alpha of finalColor instead of discarded
+#endif
+
+#ifdef TRANSPARENT_PASS
+const bool transparentPass = TRANSPARENT_PASS; // If we are accumulating transparent surfaces instead of drawing opaque ones
+#else
+uniform bool transparentPass; // If we are accumulating transparent surfaces instead of drawing opaque ones
+#endif
+
+layout(location = 0) out vec4 finalColor; // The final fragment color, or the weighted premultiplied color in the transparent pass
+layout(location = 1) out float finalRevealage; // The opacity of this fragment in the transparent pass, unused otherwise
+
+// The screen space derivatives of our inputs, taken once at the top of main where control flow is uniform.
+// Materials and their textures differ per primitive so everything that reads these may be in non-uniform control flow.
+struct Derivatives {
+	vec3 positionDx; // The change in fragPosition to the next fragment in x
+	vec3 positionDy; // The change in fragPosition to the next fragment in y
+	vec2 texCoordDx; // The change in fragTexCoord to the next fragment in x
+	vec2 texCoordDy; // The change in fragTexCoord to the next fragment in y
+};
+
+vec4 sampleLevels(sampler2DArray textures, vec3 coord, Derivatives derivatives, float minLevel) {
+	// Pick the level from the texel footprint of the derivatives, textureSize needs no derivatives of its own
+	const vec2 size = vec2(textureSize(textures, 0).xy);
+	const float footprint = max(length(derivatives.texCoordDx * size), length(derivatives.texCoordDy * size));
+	const float level = log2(max(footprint, EPSILON));
+
+	// Textures stream in from their least detailed level, never sample the levels that haven't arrived yet
+	return textureLod(textures, coord, max(level, minLevel));
+}
+
+vec4 sampleTexture(int handle, Derivatives derivatives) {
+	const vec3 coord = vec3(fragTexCoord, handle & 0xFFFF);
+	const float minLevel = float((handle >> 24) & 0xF);
+
+	// Sampler arrays can only be indexed with constants for every invocation
+	switch ((handle >> 16) & 0xFF) {
+		case 0: return sampleLevels(textureArrays[0], coord, derivatives, minLevel);
+		case 1: return sampleLevels(textureArrays[1], coord, derivatives, minLevel);
+		case 2: return sampleLevels(textureArrays[2], coord, derivatives, minLevel);
+		case 3: return sampleLevels(textureArrays[3], coord, derivatives, minLevel);
+		case 4: return sampleLevels(textureArrays[4], coord, derivatives, minLevel);
+		case 5: return sampleLevels(textureArrays[5], coord, derivatives, minLevel);
+		case 6: return sampleLevels(textureArrays[6], coord, derivatives, minLevel);
+		case 7: return sampleLevels(textureArrays[7], coord, derivatives, minLevel);
+	}
+
+	return vec4(1.0);
+}
 
-out vec4 finalColor; // The final fragment color
+vec3 perturbNormal(vec3 surfaceNormal, vec3 mapNormal, Derivatives derivatives) {
+	// Build the tangent frame from screen space derivatives since our vertices don't have tangents
+	const vec3 dp1 = derivatives.positionDx;
+	const vec3 dp2 = derivatives.positionDy;
+	const vec2 duv1 = derivatives.texCoordDx;
+	const vec2 duv2 = derivatives.texCoordDy;
 
-vec3 calculatePointLight(PointLight light) {
+	const vec3 dp2perp = cross(dp2, surfaceNormal);
+	const vec3 dp1perp = cross(surfaceNormal, dp1);
+	const vec3 tangent = dp2perp * duv1.x + dp1perp * duv2.x;
+	const vec3 bitangent = dp2perp * duv1.y + dp1perp * duv2.y;
+	const float invMax = inversesqrt(max(dot(tangent, tangent), dot(bitangent, bitangent)) + EPSILON);
+
+	return normalize(mat3(tangent * invMax, bitangent * invMax, surfaceNormal) * mapNormal);
+}
+
+vec3 calculatePointLight(PointLight light, vec3 normal, vec3 albedo) {
 	// Calculate vectors
 	vec3 lightDir = normalize(light.position - fragPosition);
 	vec3 viewDir = normalize(viewPosition - fragPosition);
 
 	// Calculate dot products
-	float dotNL = max(0.0, dot(fragNormal, lightDir));
+	float dotNL = max(0.0, dot(normal, lightDir));
 
 	// Calculate lighting factors
-	vec3 diffuseLight = fragColor * dotNL;
+	vec3 diffuseLight = albedo * dotNL;
 
 	// Calculate attenuation
 	float attenuation = 1.0 / (EPSILON + pow(distance(light.position, fragPosition), 2.0)); // We add epsilon here to prevent division by zero
@@ -41,11 +130,63 @@ vec3 calculatePointLight(PointLight light) {
 }
 
 void main() {
+	const Derivatives derivatives = Derivatives(dFdx(fragPosition), dFdy(fragPosition), dFdx(fragTexCoord), dFdy(fragTexCoord));
+	const MaterialData material = materials[fragMaterial];
+
+	// Sample the mask before anything can discard so its width is also taken in uniform control flow
+	float mask = 1.0;
+
+	if (material.alphaTexture != NO_TEXTURE) {
+		mask = sampleTexture(material.alphaTexture, derivatives).r;
+	}
+
+	const float maskWidth = fwidth(mask);
+
+	// Cut out masked texels
+	float coverage = 1.0;
+
+	if (material.alphaTexture != NO_TEXTURE) {
+		if (alphaToCoverage) {
+			// Sharpen the mask to a one pixel wide ramp around the cutoff so the samples give an anti-aliased edge
+			coverage = clamp((mask - 0.5) / max(maskWidth, 0.0001) + 0.5, 0.0, 1.0);
+		} else {
+			coverage = mask < 0.5 ? 0.0 : 1.0;
+		}
+
+		if (coverage <= 0.0) {
+			discard;
+		}
+	}
+
+	vec3 albedo = fragColor * material.diffuse.rgb;
+	vec3 normal = normalize(fragNormal);
+
+	if (material.diffuseTexture != NO_TEXTURE) {
+		albedo *= sampleTexture(material.diffuseTexture, derivatives).rgb;
+	}
+
+	if (material.normalTexture != NO_TEXTURE) {
+		// The map is stored as two channels so z is rebuilt from the unit length
+		const vec2 mapXY = sampleTexture(material.normalTexture, derivatives).rg * 2.0 - 1.0;
+		const vec3 mapNormal = vec3(mapXY, sqrt(max(1.0 - dot(mapXY, mapXY), 0.0)));
+		normal = perturbNormal(normalize(fragNormal), mapNormal, derivatives);
+	}
+
 	vec3 totalLighting = vec3(0.0);
 
 	for (uint i = 0; i < lightCount; ++i) {
-		totalLighting += calculatePointLight(lights[i]);
+		totalLighting += calculatePointLight(lights[i], normal, albedo);
 	}
 
-	finalColor = vec4(totalLighting, 1.0);
+	if (transparentPass) {
+		// Weight fragments by opacity and closeness so the nearest surfaces dominate the average
+		const float alpha = material.diffuse.a;
+		const float distance = length(fragPosition - viewPosition);
+		const float weight = alpha * clamp(10.0 / (0.00001 + pow(distance / 5.0, 2.0) + pow(distance / 200.0, 6.0)), 0.01, 3000.0);
+
+		finalColor = vec4(totalLighting * alpha, alpha) * weight;
+		finalRevealage = alpha;
+	} else {
+		finalColor = vec4(totalLighting, coverage);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#version 450 core
+
+layout(local_size_x = 64) in;
+
+struct ObjectData {
+	mat4 modelMatrix; // The model matrix of this object
+	vec4 boundingSphere; // The model space center and radius of this object
+	uint batch; // The batch this object's most detailed level is drawn in, less detailed levels follow it
+	uint lodCount; // The number of levels of detail of this object's model
+};
+
+struct DrawCommand {
+	uint count;
+	uint instanceCount;
+	uint firstIndex;
+	int baseVertex;
+	uint baseInstance;
+};
+
+struct Meshlet {
+	vec3 center; // The model space center of the bounding sphere
+	float radius; // The radius of the bounding sphere
+	vec3 coneAxis; // The average direction of the triangle normals
+	float coneCutoff; // The sine of the angle between the cone axis and the furthest normal, 1 if the cone can't be used for culling
+	uint vertexOffset; // The offset of the first vertex in meshletVertices
+	uint triangleOffset; // The offset of the first triangle in meshletTriangles
+	uint vertexCount; // The number of vertices
+	uint triangleCount; // The number of triangles
+};
+
+struct MeshletWork {
+	uint object; // The object the meshlet belongs to
+	uint meshlet; // The index of the meshlet in meshlets
+	uint command; // The draw command of the object
+	uint padding; // Matches the size of MeshletWork on the CPU
+};
+
+layout(std430, binding = 0) readonly buffer Objects {
+	ObjectData objects[]; // The data of every object in our scene
+};
+
+layout(std430, binding = 1) buffer Commands {
+	DrawCommand commands[]; // The batch draw commands followed by one draw command per meshlet culled object
+};
+
+layout(std430, binding = 2) writeonly buffer Indices {
+	uint indices[]; // The indices of the visible meshlets, grouped by object
+};
+
+layout(std430, binding = 3) readonly buffer Meshlets {
+	Meshlet meshlets[]; // The meshlets of every meshlet culled model
+};
+
+layout(std430, binding = 4) readonly buffer MeshletVertices {
+	uint meshletVertices[]; // The model vertex of each meshlet vertex
+};
+
+layout(std430, binding = 5) readonly buffer MeshletTriangles {
+	uint meshletTriangles[]; // Three 8 bit meshlet vertex indices per triangle
+};
+
+layout(std430, binding = 6) readonly buffer Work {
+	MeshletWork work[]; // One entry per meshlet of each meshlet culled object
+};
+
+#include "cull_common.glsl"
+
+uniform uint workCount; // The number of entries in work
+uniform vec3 viewPosition; // The world space position of the camera
+
+shared bool meshletVisible; // If the meshlet of this work group survived culling
+shared uint meshletOffset; // The offset of this meshlet's indices inside of its object's range
+
+bool isConeBackfacing(vec3 center, float radius, vec3 coneAxis, float coneCutoff) {
+	// Every triangle faces away from any point that sees the bounding sphere from within the cone
+	const vec3 toCenter = center - viewPosition;
+	return dot(toCenter, coneAxis) >= coneCutoff * length(toCenter) + radius;
+}
+
+void main() {
+	const uint workIndex = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+
+	if (workIndex >= workCount) {
+		return;
+	}
+
+	const MeshletWork item = work[workIndex];
+	const Meshlet meshlet = meshlets[item.meshlet];
+
+	// Cull the meshlet once per work group
+	if (gl_LocalInvocationIndex == 0) {
+		const mat4 modelMatrix = objects[item.object].modelMatrix;
+		const vec3 axisScales = vec3(length(modelMatrix[0].xyz), length(modelMatrix[1].xyz), length(modelMatrix[2].xyz));
+		const float scale = max(axisScales.x, max(axisScales.y, axisScales.z));
+		const vec3 center = vec3(modelMatrix * vec4(meshlet.center, 1.0));
+		const vec3 coneAxis = normalize(mat3(modelMatrix) * meshlet.coneAxis);
+		const float radius = meshlet.radius * scale;
+
+		// Non-uniform scale bends the normals so the cone no longer bounds them, only rotation and uniform scale keep it valid
+		const bool uniformScale = scale - min(axisScales.x, min(axisScales.y, axisScales.z)) <= 0.001 * scale;
+
+		bool visible = isSphereVisible(center, radius);
+		visible = visible && !(uniformScale && isConeBackfacing(center, radius, coneAxis, meshlet.coneCutoff));
+		visible = visible && !(occlusionCulling && isSphereOccluded(center, radius));
+
+		// Reserve room for our indices in the object's range
+		if (visible) {
+			meshletOffset = atomicAdd(commands[item.command].count, meshlet.triangleCount * 3);
+		}
+
+		meshletVisible = visible;
+	}
+
+	barrier();
+
+	if (!meshletVisible) {
+		return;
+	}
+
+	// Write the indices of the meshlet, relative to the base vertex of the model
+	const uint firstIndex = commands[item.command].firstIndex + meshletOffset;
+
+	for (uint i = gl_LocalInvocationIndex; i < meshlet.triangleCount; i += gl_WorkGroupSize.x) {
+		const uint triangle = meshletTriangles[meshlet.triangleOffset + i];
+
+		for (uint j = 0; j < 3; ++j) {
+			indices[firstIndex + i * 3 + j] = meshletVertices[meshlet.vertexOffset + ((triangle >> (8u * j)) & 0xFFu)];
+		}
+	}
+}
\ No newline at end of file
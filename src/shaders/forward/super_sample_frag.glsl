@@ -4,7 +4,8 @@ in vec3 fragPosition; // The screen space position of this fragment
 in vec2 fragTexCoord; // The texture coordinates of this vertex
 
 uniform sampler2D colorAttachment; // The texture to sample from
-uniform int scale; // The scale of colorAttachment
+
+const int scale = SCALE; // The scale of colorAttachment, known at compile time so the loops unroll
 
 out vec4 finalColor; // The final fragment color
 
@@ -1,7 +1,8 @@
 #version 450 core
 
-in vec3 vertPosition; // The position of this vertex in screen space
-in vec2 vertTexCoord; // The texture coordinates of this vertex
+// The locations match the vertex format of GeometryArena
+layout(location = 0) in vec3 vertPosition; // The position of this vertex in screen space
+layout(location = 3) in vec2 vertTexCoord; // The texture coordinates of this vertex
 
 out vec3 fragPosition; // The world space position of this fragment
 out vec2 fragTexCoord; // The texture coordinates of this vertex
@@ -1,21 +1,42 @@
 #version 450 core
 
-in vec3 vertPosition; // The position of this vertex in model space
-in vec3 vertNormal; // The normal of this vertex in model space
-in vec3 vertColor; // The color of this vertex
+struct ObjectData {
+	mat4 modelMatrix; // The model matrix of this object
+	vec4 boundingSphere; // The model space center and radius of this object
+	uint batch; // The batch this object is drawn in
+	uint lodCount; // The number of levels of detail of this object's model
+	uint material; // The index of this object's material
+};
 
-uniform mat4 mvp; // The model view projection matrix
-uniform mat4 modelMatrix; // The model matrix
+// The locations match the vertex format of GeometryArena
+layout(location = 0) in vec3 vertPosition; // The position of this vertex in model space
+layout(location = 1) in vec3 vertNormal; // The normal of this vertex in model space
+layout(location = 2) in vec3 vertColor; // The color of this vertex
+layout(location = 3) in vec2 vertTexCoord; // The texture coordinate of this vertex
+layout(location = 4) in uint instanceObject; // The index of the object this instance draws
+
+layout(std430, binding = 0) readonly buffer Objects {
+	ObjectData objects[]; // The data of every object in our scene
+};
+
+uniform mat4 viewProjection; // The view projection matrix
 
 out vec3 fragPosition; // The world space position of this fragment
-out vec3 fragNormal; // The normal of this fragment
+out vec3 fragNormal; // The world space normal of this fragment
 out vec3 fragColor; // The interpolated fragment color
+out vec2 fragTexCoord; // The interpolated texture coordinate
+flat out uint fragMaterial; // The material of this object
 
 
 void main() {
-	gl_Position = mvp * vec4(vertPosition, 1.0);
-	fragPosition = vec3(modelMatrix * vec4(vertPosition, 1.0));
+	const mat4 modelMatrix = objects[instanceObject].modelMatrix;
+	const vec4 worldPosition = modelMatrix * vec4(vertPosition, 1.0);
+	gl_Position = viewProjection * worldPosition;
+	fragPosition = vec3(worldPosition);
 
-	fragNormal = vertNormal;
+	// Normals need the inverse transpose to stay perpendicular to surfaces under non-uniform scale
+	fragNormal = normalize(transpose(inverse(mat3(modelMatrix))) * vertNormal);
 	fragColor = vertColor;
+	fragTexCoord = vertTexCoord;
+	fragMaterial = objects[instanceObject].material;
 }
\ No newline at end of file
@@ -0,0 +1,151 @@
+// STD
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Playground
+#include <Playground/OcclusionBuffer.hpp>
+
+namespace {
+	// The buffer is 16x16 so a triangle from the bottom left corner to the far edges of NDC has integer window coordinates
+	constexpr int size = 16;
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& message) {
+		if (!condition) {
+			std::cout << "[FAILED] " << message << "\n";
+			++failures;
+		}
+	}
+
+	float getDepth(const Playground::OcclusionBuffer& buffer, int x, int y) {
+		const int pitch = (buffer.getWidth() + 3) & ~3;
+		return buffer.getDepth()[y * pitch + x];
+	}
+
+	Playground::Bounds makeBounds(const glm::vec3& min, const glm::vec3& max) {
+		return {min, max, (min + max) * 0.5f, glm::length(max - min) * 0.5f};
+	}
+
+	// Two counter clockwise triangles covering [minX, maxX] x [-1, 1] in NDC at a constant depth
+	void addQuad(Playground::OcclusionBuffer& buffer, float minX, float maxX, float z) {
+		static std::vector<glm::vec3> positions;
+		static const std::vector<GLuint> indices = {0, 1, 2, 2, 1, 3};
+
+		positions = {{minX, -1.0f, z}, {maxX, -1.0f, z}, {minX, 1.0f, z}, {maxX, 1.0f, z}};
+		buffer.addOccluder(positions, indices, glm::mat4{1.0f});
+	}
+
+	void testCoverage(Playground::ThreadPool& pool) {
+		Playground::OcclusionBuffer buffer{size, size, pool};
+		const std::vector<glm::vec3> positions = {{-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}};
+		const std::vector<GLuint> indices = {0, 1, 2};
+
+		buffer.begin(glm::mat4{1.0f});
+		buffer.addOccluder(positions, indices, glm::mat4{1.0f});
+		buffer.rasterize();
+
+		// The triangle covers every pixel center with x + y < size
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				const bool covered = (x + 0.5f) + (y + 0.5f) <= size;
+				const float expected = covered ? 0.5f : 1.0f;
+				check(getDepth(buffer, x, y) == expected, "coverage of pixel " + std::to_string(x) + ", " + std::to_string(y));
+			}
+		}
+
+		// Back facing triangles are never rasterized
+		const std::vector<GLuint> reversed = {0, 2, 1};
+		buffer.begin(glm::mat4{1.0f});
+		buffer.addOccluder(positions, reversed, glm::mat4{1.0f});
+		buffer.rasterize();
+		check(getDepth(buffer, 0, 0) == 1.0f, "back facing triangle is skipped");
+	}
+
+	void testDepthInterpolation(Playground::ThreadPool& pool) {
+		Playground::OcclusionBuffer buffer{size, size, pool};
+
+		// Window depths of 0.25, 0.5 and 0.75 at (0, 0), (size, 0) and (0, size) give the plane 0.25 + x / (4 * size) + y / (2 * size)
+		const std::vector<glm::vec3> positions = {{-1.0f, -1.0f, -0.5f}, {1.0f, -1.0f, 0.0f}, {-1.0f, 1.0f, 0.5f}};
+		const std::vector<GLuint> indices = {0, 1, 2};
+
+		buffer.begin(glm::mat4{1.0f});
+		buffer.addOccluder(positions, indices, glm::mat4{1.0f});
+		buffer.rasterize();
+
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x + y < size - 1; ++x) {
+				const float expected = 0.25f + (x + 0.5f) / (4.0f * size) + (y + 0.5f) / (2.0f * size);
+				check(std::abs(getDepth(buffer, x, y) - expected) < 1e-5f, "depth of pixel " + std::to_string(x) + ", " + std::to_string(y));
+			}
+		}
+	}
+
+	void testOccludedQuery(Playground::ThreadPool& pool) {
+		Playground::OcclusionBuffer buffer{size, size, pool};
+
+		// A near occluder covering the whole screen hides a box behind it
+		buffer.begin(glm::mat4{1.0f});
+		addQuad(buffer, -1.0f, 1.0f, 0.0f);
+		buffer.rasterize();
+
+		check(!buffer.isVisible(makeBounds({-0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.6f}), glm::mat4{1.0f}), "box behind a full screen occluder is occluded");
+		check(buffer.isVisible(makeBounds({-0.5f, -0.5f, -0.6f}, {0.5f, 0.5f, -0.5f}), glm::mat4{1.0f}), "box in front of the occluder is visible");
+	}
+
+	void testPartiallyVisibleQuery(Playground::ThreadPool& pool) {
+		Playground::OcclusionBuffer buffer{size, size, pool};
+
+		// The occluder only covers the left half of the screen, so a box straddling the middle is still visible on the right
+		buffer.begin(glm::mat4{1.0f});
+		addQuad(buffer, -1.0f, 0.0f, 0.0f);
+		buffer.rasterize();
+
+		check(buffer.isVisible(makeBounds({-0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.6f}), glm::mat4{1.0f}), "box partially behind the occluder is visible");
+		check(!buffer.isVisible(makeBounds({-0.75f, -0.5f, 0.5f}, {-0.25f, 0.5f, 0.6f}), glm::mat4{1.0f}), "box entirely behind the occluder is occluded");
+	}
+
+	void testIndexRanges(Playground::ThreadPool& pool) {
+		Playground::OcclusionBuffer buffer{size, size, pool};
+
+		// Two quads side by side in one mesh, only the left and right thirds are added as ranges so the middle stays empty
+		const std::vector<glm::vec3> positions = {
+			{-1.0f, -1.0f, 0.0f}, {-0.5f, -1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}, {-0.5f, 1.0f, 0.0f},
+			{-0.5f, -1.0f, 0.0f}, {0.5f, -1.0f, 0.0f}, {-0.5f, 1.0f, 0.0f}, {0.5f, 1.0f, 0.0f},
+			{0.5f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {0.5f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}
+		};
+		const std::vector<GLuint> indices = {0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7, 8, 9, 10, 10, 9, 11};
+
+		buffer.begin(glm::mat4{1.0f});
+		buffer.addOccluder(positions, indices, glm::mat4{1.0f}, 0, 6);
+		buffer.addOccluder(positions, indices, glm::mat4{1.0f}, 12, 6);
+		buffer.rasterize();
+
+		check(getDepth(buffer, 1, 8) == 0.5f, "left range is rasterized");
+		check(getDepth(buffer, 8, 8) == 1.0f, "indices outside the ranges are skipped");
+		check(getDepth(buffer, 14, 8) == 0.5f, "right range is rasterized");
+	}
+}
+
+int main() {
+	Playground::ThreadPool pool{4};
+
+	testCoverage(pool);
+	testDepthInterpolation(pool);
+	testOccludedQuery(pool);
+	testPartiallyVisibleQuery(pool);
+	testIndexRanges(pool);
+
+	if (failures > 0) {
+		std::cout << failures << " checks failed\n";
+		return 1;
+	}
+
+	std::cout << "All checks passed\n";
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+// STD
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Playground
+#include <Playground/Scene.hpp>
+
+namespace {
+	int failures = 0;
+
+	void check(bool condition, const std::string& message) {
+		if (!condition) {
+			std::cout << "[FAILED] " << message << "\n";
+			++failures;
+		}
+	}
+
+	bool isNear(const glm::vec3& a, const glm::vec3& b) {
+		return glm::length(a - b) < 1e-4f;
+	}
+
+	glm::vec3 getWorldPosition(const Playground::Scene& scene, GLuint node) {
+		return glm::vec3{scene.getWorldMatrix(node)[3]};
+	}
+
+	void testInitialUpdate() {
+		Playground::Scene scene;
+		const GLuint parent = scene.addNode(nullptr, {1.0f, 0.0f, 0.0f});
+		const GLuint child = scene.addNode(nullptr, {0.0f, 2.0f, 0.0f}, false, parent);
+
+		scene.update();
+
+		// New nodes start with the identity rotation and scale
+		check(isNear(getWorldPosition(scene, parent), {1.0f, 0.0f, 0.0f}), "parent world position after the first update");
+		check(isNear(getWorldPosition(scene, child), {1.0f, 2.0f, 0.0f}), "child world position after the first update");
+		check(isNear(glm::vec3{scene.getWorldMatrix(child)[0]}, {1.0f, 0.0f, 0.0f}), "child world x axis after the first update");
+		check(scene.getChangedNodes().size() == 2, "every new node changes in the first update");
+	}
+
+	void testParentMovesChild() {
+		Playground::Scene scene;
+		const GLuint parent = scene.addNode(nullptr, {0.0f, 0.0f, 0.0f});
+		const GLuint child = scene.addNode(nullptr, {0.0f, 0.0f, -4.0f}, false, parent);
+		const GLuint other = scene.addNode(nullptr, {5.0f, 0.0f, 0.0f});
+		scene.update();
+
+		// Rotate the parent a quarter turn around y and lift it, the child follows both
+		scene.setTranslation(parent, {0.0f, 1.0f, 0.0f});
+		scene.setRotation(parent, glm::angleAxis(glm::radians(90.0f), glm::vec3{0.0f, 1.0f, 0.0f}));
+		scene.update();
+
+		check(isNear(getWorldPosition(scene, child), {-4.0f, 1.0f, 0.0f}), "child follows the moved and rotated parent");
+		check(isNear(getWorldPosition(scene, other), {5.0f, 0.0f, 0.0f}), "unrelated node stays put");
+
+		const auto& changed = scene.getChangedNodes();
+		check(changed == std::vector<GLuint>({parent, child}), "only the parent and its child change");
+
+		// Scaling the parent scales the child's offset
+		scene.setScale(parent, {2.0f, 2.0f, 2.0f});
+		scene.update();
+		check(isNear(getWorldPosition(scene, child), {-8.0f, 1.0f, 0.0f}), "child offset follows the parent scale");
+	}
+
+	void testUnchangedUpdate() {
+		Playground::Scene scene;
+		const GLuint parent = scene.addNode(nullptr, {0.0f, 0.0f, 0.0f});
+		scene.addNode(nullptr, {0.0f, 0.0f, -4.0f}, false, parent);
+		scene.update();
+
+		// Nothing moved so nothing is recomputed
+		scene.update();
+		check(scene.getChangedNodes().empty(), "an update without changes recomputes nothing");
+
+		// Moving only the child leaves its parent alone
+		scene.setTranslation(1, {0.0f, 0.0f, -2.0f});
+		scene.update();
+		check(scene.getChangedNodes() == std::vector<GLuint>({1}), "moving a child doesn't change its parent");
+	}
+}
+
+int main() {
+	testInitialUpdate();
+	testParentMovesChild();
+	testUnchangedUpdate();
+
+	if (failures > 0) {
+		std::cout << failures << " checks failed\n";
+		return 1;
+	}
+
+	std::cout << "All checks passed\n";
+	return 0;
+}
\ No newline at end of file